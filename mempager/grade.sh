@@ -4,28 +4,58 @@ set -u
 TESTSPEC=mempager-tests/tests.spec
 # TESTSPEC=mempager-tests/test11.spec
 
+# Each line of TESTSPEC is `NUM FRAMES BLOCKS NODIFF [VARIANT OPTION...]`.
+# NODIFF 0 compares the MMU log and the test output, 2 compares only
+# the test output (for options that start background threads, whose
+# log order varies), and 1 compares neither.  VARIANT names a run of
+# testNUM with the MMU options that follow it; its outputs are
+# testNUM.VARIANT.out and testNUM.VARIANT.mmu.out.  Unless NODIFF is
+# 1, each line `COUNTER OP VALUE` of mempager-tests/NAME.stats must
+# hold for the counters printed by the MMU option stats=1, where OP is
+# <, > or = and VALUE is a number or another counter (`dedup 3/40`
+# gives `dedup` 3).
+
 make
 
-while read -r num frames blocks nodiff ; do
+check_stats() {
+    awk -v name=$1 'NR == FNR {
+            if ($1 == "pager_stats")
+                for (i = 2; i < NF; i += 2) { split($(i + 1), v, "/"); s[$i] = v[1] }
+            next
+        }
+        {
+            a = ($1 in s) ? s[$1] : $1; b = ($3 in s) ? s[$3] : $3
+            if (!(($2 == "<" && a + 0 < b + 0) || ($2 == ">" && a + 0 > b + 0) || ($2 == "=" && a + 0 == b + 0))) {
+                print name ".stats: " $0 " fails (" a " " $2 " " b ")"; bad = 1
+            }
+        }
+        END { exit bad }' $1.mmu.out mempager-tests/$1.stats
+}
+
+while read -r num frames blocks nodiff variant opts ; do
     num=$((num))
     frames=$((frames))
     blocks=$((blocks))
     nodiff=$((nodiff))
-    echo "running test$num"
+    name=test$num${variant:+.$variant}
+    echo "running $name"
     rm -rf mmu.sock mmu.pmem.img.*
-    ./bin/mmu $frames $blocks &> test$num.mmu.out &
+    ./bin/mmu $frames $blocks $opts &> $name.mmu.out &
     sleep 1s
-    ./bin/test$num &> test$num.out
+    ./bin/test$num &> $name.out
     kill -SIGINT %1
     wait
     rm -rf mmu.sock mmu.pmem.img.*
     if [ $nodiff -eq 1 ] ; then
         continue
     fi
-    if ! diff mempager-tests/test$num.mmu.out test$num.mmu.out > /dev/null ; then
-        echo "test$num.mmu.out differs"
+    if [ $nodiff -eq 0 ] && ! diff mempager-tests/$name.mmu.out $name.mmu.out > /dev/null ; then
+        echo "$name.mmu.out differs"
+    fi
+    if ! diff mempager-tests/$name.out $name.out > /dev/null ; then
+        echo "$name.out differs"
     fi
-    if ! diff mempager-tests/test$num.out test$num.out > /dev/null ; then
-        echo "test$num.out differs"
+    if [ -f mempager-tests/$name.stats ] ; then
+        check_stats $name
     fi
 done < $TESTSPEC
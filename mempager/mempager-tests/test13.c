@@ -0,0 +1,62 @@
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uvm.h"
+
+int num_pages = 6; /* test with mmu 4 32 */
+char *pages[6];
+
+void check(char owner) {
+	for(int i = 0; i < num_pages; ++i) {
+		assert(pages[i][0] == owner);
+		assert(pages[i][1] == 'a' + i);
+	}
+}
+
+void fill(char owner) {
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i][0] = owner;
+		pages[i][1] = 'a' + i;
+	}
+}
+
+int main(void) {
+	uvm_create();
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i] = uvm_extend();
+	}
+	fill('p');
+
+	pid_t pid = uvm_fork();
+	assert(pid != -1);
+	if(pid == 0) {
+		check('p');
+		pid_t grandchild = uvm_fork();
+		assert(grandchild != -1);
+		if(grandchild == 0) {
+			check('p');
+			fill('g');
+			check('g');
+			uvm_syslog(pages[0], 2);
+			exit(EXIT_SUCCESS);
+		}
+		fill('c');
+		waitpid(grandchild, NULL, 0);
+		check('c');
+		uvm_syslog(pages[0], 2);
+		printf("child and grandchild have their own copies\n");
+		exit(EXIT_SUCCESS);
+	}
+
+	waitpid(pid, NULL, 0);
+	check('p');
+	uvm_syslog(pages[0], 2);
+	printf("parent kept its pages\n");
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,32 @@
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uvm.h"
+
+int main(void) {
+	uvm_create();
+	long pagesz = sysconf(_SC_PAGESIZE);
+	char *range = uvm_extend_n(6); /* test with mmu 4 8 */
+	assert(range != NULL);
+	for(int i = 0; i < 6; ++i) {
+		range[i * pagesz] = 'a' + i;
+	}
+
+	assert(uvm_extend_n(3) == NULL);
+	assert(errno == ENOSPC);
+	char *rest = uvm_extend_n(2);
+	assert(rest == range + 6 * pagesz);
+	strcpy(rest, "range");
+	assert(uvm_extend() == NULL);
+
+	for(int i = 0; i < 6; ++i) {
+		assert(range[i * pagesz] == 'a' + i);
+	}
+	uvm_syslog(rest, strlen(rest) + 1);
+	printf("allocated 8 pages in two ranges\n");
+	exit(EXIT_SUCCESS);
+}
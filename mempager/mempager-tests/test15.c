@@ -0,0 +1,36 @@
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uvm.h"
+
+int num_pages = 6; /* test with mmu 4 8 */
+char *pages[6];
+
+int main(void) {
+	uvm_create();
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i] = uvm_extend();
+		pages[i][0] = 'a' + i;
+	}
+	long pagesz = sysconf(_SC_PAGESIZE);
+
+	assert(uvm_release(pages[0] + 1, pagesz) == -1);
+	assert(errno == EINVAL);
+	assert(uvm_release(pages[1], 3 * pagesz) == 0);
+
+	printf("released pages should print zeros:\n");
+	for(int i = 1; i < 4; ++i) {
+		printf("%c\n", pages[i][0]);
+	}
+	pages[2][0] = 'z';
+	assert(pages[0][0] == 'a');
+	assert(pages[2][0] == 'z');
+	assert(pages[4][0] == 'e');
+	assert(pages[5][0] == 'f');
+	uvm_syslog(pages[2], 1);
+	exit(EXIT_SUCCESS);
+}
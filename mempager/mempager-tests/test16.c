@@ -0,0 +1,41 @@
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uvm.h"
+
+int num_pages = 6; /* test with mmu 4 8 */
+char *pages[6];
+
+int main(void) {
+	uvm_create();
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i] = uvm_extend();
+		pages[i][0] = 'a' + i;
+	}
+	long pagesz = sysconf(_SC_PAGESIZE);
+
+	assert(uvm_advise(pages[0], pagesz, 42) == -1);
+	assert(errno == EINVAL);
+	assert(uvm_advise(pages[0] + 1, pagesz, UVM_ADV_COLD) == -1);
+	assert(errno == EINVAL);
+
+	/* page 5 is resident and becomes the next victim */
+	assert(uvm_advise(pages[5], pagesz, UVM_ADV_COLD) == 0);
+	printf("%c\n", pages[0][0]);
+	/* page 1 is read from disk before it is touched */
+	assert(uvm_advise(pages[1], pagesz, UVM_ADV_WILLNEED) == 0);
+	printf("%c\n", pages[1][0]);
+	assert(uvm_advise(pages[2], 2 * pagesz, UVM_ADV_SEQUENTIAL) == 0);
+	assert(uvm_advise(pages[3], pagesz, UVM_ADV_DONTNEED) == 0);
+	printf("released page should print zero:\n");
+	printf("%c\n", pages[3][0]);
+	assert(pages[2][0] == 'c');
+	assert(pages[4][0] == 'e');
+	assert(pages[5][0] == 'f');
+	uvm_syslog(pages[5], 1);
+	exit(EXIT_SUCCESS);
+}
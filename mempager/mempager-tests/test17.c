@@ -0,0 +1,40 @@
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uvm.h"
+
+int num_pages = 6; /* test with mmu 4 8 */
+char *pages[6];
+
+int main(void) {
+	uvm_create();
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i] = uvm_extend();
+	}
+	long pagesz = sysconf(_SC_PAGESIZE);
+
+	assert(uvm_lock(pages[0] + 1, pagesz) == -1);
+	assert(errno == EINVAL);
+	/* one page per process with 4 frames */
+	assert(uvm_lock(pages[0], 2 * pagesz) == -1);
+	assert(errno == ENOMEM);
+	assert(uvm_lock(pages[0], pagesz) == 0);
+
+	/* the pinned page is never paged out and only traps on its first write */
+	for(int loop = 0; loop < 2; ++loop) {
+		for(int i = 0; i < num_pages; ++i) {
+			pages[i][0] = 'a' + i;
+		}
+	}
+	assert(uvm_unlock(pages[0], pagesz) == 0);
+	for(int i = 1; i < num_pages; ++i) {
+		pages[i][1] = 'a' + i;
+	}
+	printf("%c\n", pages[0][0]);
+	uvm_syslog(pages[0], 1);
+	exit(EXIT_SUCCESS);
+}
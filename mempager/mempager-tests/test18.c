@@ -0,0 +1,65 @@
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "uvm.h"
+
+int num_pages = 6; /* test with mmu 8 16 */
+char *pages[9];
+
+void print_usage(void) {
+	struct uvm_usage usage;
+	assert(uvm_getusage(0, &usage) == 0);
+	printf("resident %lu swapped %lu dirty %lu faults %lu pages %lu\n",
+			usage.resident, usage.swapped, usage.dirty,
+			usage.faults, usage.pages);
+}
+
+int main(void) {
+	uvm_create();
+	assert(uvm_setlimit(0, UVM_LIMIT_COUNT, 1) == -1);
+	assert(errno == EINVAL);
+	assert(uvm_setlimit(1, UVM_LIMIT_RESIDENT, 1) == -1);
+	assert(errno == ESRCH);
+
+	assert(uvm_setlimit(0, UVM_LIMIT_PAGES, num_pages) == 0);
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i] = uvm_extend();
+	}
+	assert(uvm_extend() == NULL);
+
+	/* two frames out of eight: the process pages out its own pages */
+	assert(uvm_setlimit(0, UVM_LIMIT_RESIDENT, 2) == 0);
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i][0] = 'a' + i;
+	}
+	print_usage();
+
+	/* pages read back from disk make room on disk for the ones they
+	 * replace */
+	assert(uvm_setlimit(0, UVM_LIMIT_SWAP, 4) == 0);
+	printf("%c%c\n", pages[0][0], pages[1][0]);
+	print_usage();
+
+	/* a new page cannot be written out by a child at the swap limit */
+	fflush(stdout);
+	pid_t pid = uvm_fork();
+	assert(pid != -1);
+	if(pid == 0) {
+		assert(uvm_setlimit(0, UVM_LIMIT_PAGES, 9) == 0);
+		for(int i = num_pages; i < 9; ++i) {
+			pages[i] = uvm_extend();
+			pages[i][0] = 'a' + i;
+		}
+		exit(EXIT_SUCCESS);
+	}
+	int status;
+	waitpid(pid, &status, 0);
+	printf("child exit %d\n", WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+	print_usage();
+	exit(EXIT_SUCCESS);
+}
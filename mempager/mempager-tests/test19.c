@@ -0,0 +1,45 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uvm.h"
+
+int num_pages = 9; /* test with mmu 8 16 dedup=10 */
+char *pages[9];
+
+char content(int i) {
+	return i >= 1 && i <= 6 ? 's' : 'a' + i;
+}
+
+int main(void) {
+	uvm_create();
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i] = uvm_extend();
+	}
+	/* pages 1 to 6 have the same content; the sweep that makes room
+	 * for the last page evicts page 0 and write-protects the others,
+	 * which the scanner can then merge into a single frame */
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i][0] = content(i);
+	}
+	struct uvm_usage usage;
+	int polls = 0;
+	do {
+		usleep(10000);
+		assert(uvm_getusage(0, &usage) == 0);
+	} while(usage.resident > 3 && ++polls < 500);
+	printf("resident %lu\n", usage.resident);
+
+	/* a write to a merged page gives it its own copy */
+	pages[1][1] = 'w';
+	assert(uvm_getusage(0, &usage) == 0);
+	printf("resident %lu\n", usage.resident);
+	for(int i = 0; i < num_pages; ++i) {
+		assert(pages[i][0] == content(i));
+		printf("%c%c\n", pages[i][0], pages[i][1] ? pages[i][1] : '0');
+	}
+	uvm_syslog(pages[2], 2);
+	exit(EXIT_SUCCESS);
+}
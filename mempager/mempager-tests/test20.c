@@ -0,0 +1,40 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uvm.h"
+
+int max_pages = 12; /* test with mmu 4 4 in each overcommit mode */
+char *pages[12];
+
+int main(void) {
+	uvm_create();
+	int num_pages = 0;
+	while(num_pages < max_pages &&
+			(pages[num_pages] = uvm_extend()) != NULL) {
+		num_pages++;
+	}
+	printf("extended %d pages\n", num_pages);
+
+	/* pages that were never written are paged out without a block */
+	for(int i = 0; i < num_pages; ++i) {
+		assert(pages[i][0] == '0');
+	}
+	printf("read %d pages\n", num_pages);
+	fflush(stdout);
+
+	/* four frames and four blocks hold the written pages of the strict
+	 * and ratio modes; in the unlimited mode a fault finds no block for
+	 * any victim and the process is terminated */
+	for(int i = 0; i < num_pages; ++i) {
+		pages[i][0] = 'a' + i;
+	}
+	for(int i = 0; i < num_pages; ++i) {
+		assert(pages[i][0] == 'a' + i);
+	}
+	printf("wrote %d pages\n", num_pages);
+	uvm_syslog(pages[num_pages - 1], 1);
+	exit(EXIT_SUCCESS);
+}
@@ -10,3 +10,30 @@
 10 4 8 0
 11 2 3 1
 12 256 1024 1
+13 4 32 1
+14 4 8 0
+15 4 8 0
+16 4 8 0
+17 4 8 0
+18 8 16 0
+20 4 4 0
+9 4 8 0 lru policy=lru
+9 4 8 0 clockpro policy=clockpro
+9 4 8 0 2q policy=2q
+9 4 8 0 arc policy=arc
+9 4 8 0 nru policy=nru
+9 4 8 2 reclaim lowmark=1 highmark=3 stats=1
+17 4 8 2 writeback policy=nru writeback=1 stats=1
+15 4 8 0 pff pff=1
+17 4 8 0 readahead readahead=4
+13 4 32 2 readahead readahead=4
+9 4 8 0 faultaround faultaround=4
+9 4 8 0 chprotvec chprotvec=1
+8 4 8 0 zeropage zeropage=1
+9 4 8 0 zeropage zeropage=1
+19 8 16 2 dedup dedup=10 stats=1
+9 4 8 0 zswap zswap=4
+18 8 16 0 swapcache swapcache=1
+20 4 4 0 ratio overcommit=ratio commitratio=50
+20 4 4 0 unlimited overcommit=unlimited
+13 64 64 2 magazine magazine=8 stats=1
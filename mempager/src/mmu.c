@@ -16,15 +16,13 @@
 
 #include "log.h"
 
+#include "mmu.h"
 #include "pager.h"
 #include "mmuproto.h"
 
 #define MMU_MAX_EVENTS 32
-#define MMU_MAX_SOCK 1024
 
-
-pid_t id2pid[UINT8_MAX];
-uint8_t nextid = 0;
+intptr_t uvm_maxaddr = UVM_DEFAULT_MAXADDR;
 
 /****************************************************************************
  * structure definitions and static variables
@@ -37,7 +35,11 @@ struct mmu_data {/*{{{*/
 	char *pmem_fn;
 	int pmem_fd;
 	int sock;
-	struct mmu_client * sock2client[MMU_MAX_SOCK];
+	/* indexed by socket, doubled when a socket does not fit; only
+	 * the accept loop grows it, and every update takes `sock_lock`: */
+	int nsocks;
+	struct mmu_client ** sock2client;
+	pthread_mutex_t sock_lock;
 };/*}}}*/
 struct mmu_client {/*{{{*/
 	int running;
@@ -58,12 +60,95 @@ static void mmu_shutdown_action(int signum, siginfo_t *si, void *context);
 static void mmu_accept_loop(void);
 static void * mmu_client_thread(void *vclient);
 
+/* Client PIDs, with the sequential id printed in place of each PID
+ * and the client currently serving it, in an open-addressing hash
+ * table (linear probing) that doubles when half full.  Lookups by
+ * `get_pid_id` and `mmu_client_search` take constant time with any
+ * number of processes.  Slots are kept after a client exits, so
+ * later messages about the process still print its id. */
+struct mmu_pid_slot {/*{{{*/
+	pid_t pid;
+	int id;
+	struct mmu_client *client;
+};/*}}}*/
+static struct mmu_pid_slot *pid_slots = NULL;
+static size_t pid_mask = 0;
+static size_t pid_used = 0;
+static int nextid = 0;
+static pthread_rwlock_t pid_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/* Returns the slot of `pid`, or the empty slot where it would be
+ * inserted.  Requires `pid_lock`. */
+static struct mmu_pid_slot * pid_slot(pid_t pid)/*{{{*/
+{
+	size_t i = ((size_t)pid * 2654435761u) & pid_mask;
+	while(pid_slots[i].pid != 0 && pid_slots[i].pid != pid)
+		i = (i + 1) & pid_mask;
+	return &pid_slots[i];
+}/*}}}*/
+
+/* Gives `pid` the next id and binds it to client `c`. */
+static int pid_register(pid_t pid, struct mmu_client *c)/*{{{*/
+{
+	pthread_rwlock_wrlock(&pid_lock);
+	if(2 * (pid_used + 1) > pid_mask + 1) {
+		struct mmu_pid_slot *old = pid_slots;
+		size_t oldsz = pid_mask + 1;
+		pid_mask = 2 * oldsz - 1;
+		pid_slots = calloc(pid_mask + 1, sizeof(*pid_slots));
+		if(!pid_slots) logea(__FILE__, __LINE__, NULL);
+		for(size_t i = 0; i < oldsz; ++i) {
+			if(old[i].pid != 0) *pid_slot(old[i].pid) = old[i];
+		}
+		free(old);
+	}
+	struct mmu_pid_slot *slot = pid_slot(pid);
+	if(slot->pid == 0) pid_used++;
+	slot->pid = pid;
+	slot->id = nextid++;
+	slot->client = c;
+	int id = slot->id;
+	pthread_rwlock_unlock(&pid_lock);
+	return id;
+}/*}}}*/
+
+/* Unbinds client `c` from its PID, if still bound. */
+static void pid_unbind(struct mmu_client *c)/*{{{*/
+{
+	pthread_rwlock_wrlock(&pid_lock);
+	struct mmu_pid_slot *slot = pid_slot(c->pid);
+	if(slot->pid == c->pid && slot->client == c) slot->client = NULL;
+	pthread_rwlock_unlock(&pid_lock);
+}/*}}}*/
+
 int get_pid_id(pid_t pid) {
-	int i = 0;
-	for(; id2pid[i] != pid; i++);
-	return i;
+	pthread_rwlock_rdlock(&pid_lock);
+	struct mmu_pid_slot *slot = pid_slot(pid);
+	int id = slot->pid == pid ? slot->id : -1;
+	pthread_rwlock_unlock(&pid_lock);
+	return id;
 }
 
+/* Binds socket `sock` to client `c` (or unbinds it if `c` is NULL),
+ * doubling `sock2client` until the socket fits. */
+static void sock2client_set(int sock, struct mmu_client *c)/*{{{*/
+{
+	pthread_mutex_lock(&mmu->sock_lock);
+	if(sock >= mmu->nsocks) {
+		int nsocks = mmu->nsocks;
+		while(sock >= nsocks) nsocks *= 2;
+		struct mmu_client **table = realloc(mmu->sock2client,
+				nsocks * sizeof(table[0]));
+		if(!table) logea(__FILE__, __LINE__, NULL);
+		memset(table + mmu->nsocks, 0,
+				(nsocks - mmu->nsocks) * sizeof(table[0]));
+		mmu->sock2client = table;
+		mmu->nsocks = nsocks;
+	}
+	mmu->sock2client[sock] = c;
+	pthread_mutex_unlock(&mmu->sock_lock);
+}/*}}}*/
+
 /****************************************************************************
  * initialization functions {{{
  ***************************************************************************/
@@ -86,7 +171,13 @@ void mmu_init(int npages, int nblocks)/*{{{*/
 	mmu_init_pmem(npages);
 	mmu_init_sock();
 	mmu_init_sigs();
-	memset(mmu->sock2client, 0, MMU_MAX_SOCK*sizeof(mmu->sock2client[0]));
+	mmu->nsocks = 64;
+	mmu->sock2client = calloc(mmu->nsocks, sizeof(mmu->sock2client[0]));
+	if(!mmu->sock2client) logea(__FILE__, __LINE__, NULL);
+	pthread_mutex_init(&mmu->sock_lock, NULL);
+	pid_mask = 63;
+	pid_slots = calloc(pid_mask + 1, sizeof(*pid_slots));
+	if(!pid_slots) logea(__FILE__, __LINE__, NULL);
 }/*}}}*/
 
 void mmu_init_disk(int nblocks)/*{{{*/
@@ -107,9 +198,8 @@ void mmu_init_pmem(int npages)/*{{{*/
 			mmu->pmem_fn);
 
 	size_t memsz = PAGESIZE * npages;
-	for(size_t i = 0; i < npages*PAGESIZE; ++i) {
-		write(mmu->pmem_fd, "z", 1);
-	}
+	if(ftruncate(mmu->pmem_fd, memsz) == -1)
+		logea(__FILE__, __LINE__, NULL);
 
 	int prot = PROT_READ | PROT_WRITE;
 	mmu->pmem = mmap(NULL, memsz, prot, MAP_SHARED, mmu->pmem_fd, 0);
@@ -156,10 +246,12 @@ void mmu_destroy(void)/*{{{*/
 	assert(mmu);
 	unlink(mmu->pmem_fn);
 	free(mmu->pmem_fn);
-	for(int i = 3; i < MMU_MAX_SOCK; ++i) {
+	for(int i = 3; i < mmu->nsocks; ++i) {
 		if(!mmu->sock2client[i]) continue;
 		mmu_client_destroy(mmu->sock2client[i]);
 	}
+	free(mmu->sock2client);
+	pthread_mutex_destroy(&mmu->sock_lock);
 	munmap(mmu->pmem, mmu->npages * PAGESIZE);
 	free(mmu->disk);
 	close(mmu->sock);
@@ -182,6 +274,11 @@ void mmu_shutdown_action(int signum, siginfo_t *si, void *context)/*{{{*/
  ***************************************************************************/
 void mmu_accept_loop(void)/*{{{*/
 {
+	/* SIGINT must interrupt `accept` in this thread, so client threads
+	 * are created with it blocked. */
+	sigset_t sigint;
+	sigemptyset(&sigint);
+	sigaddset(&sigint, SIGINT);
 	while(mmu->running) {
 		struct sockaddr_un addr;
 		socklen_t addrlen = sizeof(addr);
@@ -192,11 +289,13 @@ void mmu_accept_loop(void)/*{{{*/
 		logd(LOG_DEBUG, "%s: creating thread\n", __func__);
 		struct mmu_client *c = malloc(sizeof(*c));
 		if(!c) logea(__FILE__, __LINE__, NULL);
-		mmu->sock2client[nsock] = c;
+		sock2client_set(nsock, c);
 		c->running = 1;
 		c->sock = nsock;
 		c->pid = 0;
+		pthread_sigmask(SIG_BLOCK, &sigint, NULL);
 		pthread_create(&c->thread, NULL, mmu_client_thread, c);
+		pthread_sigmask(SIG_UNBLOCK, &sigint, NULL);
 		pthread_detach(c->thread);
 	}
 	logd(LOG_DEBUG, "%s: exiting\n", __func__);
@@ -204,8 +303,16 @@ void mmu_accept_loop(void)/*{{{*/
 
 static void mmu_client_log(const struct mmu_client *c, const char *fname, const char *msg);
 static void mmu_client_create(struct mmu_client *c);
+static void mmu_client_fork(struct mmu_client *c);
 static void mmu_client_extend(struct mmu_client *c);
+static void mmu_client_extend_range(struct mmu_client *c);
 static void mmu_client_syslog(struct mmu_client *c);
+static void mmu_client_release(struct mmu_client *c);
+static void mmu_client_advise(struct mmu_client *c);
+static void mmu_client_lock(struct mmu_client *c);
+static void mmu_client_unlock(struct mmu_client *c);
+static void mmu_client_setlimit(struct mmu_client *c);
+static void mmu_client_usage(struct mmu_client *c);
 static void mmu_client_segv(struct mmu_client *c);
 static void mmu_client_exit(struct mmu_client *c);
 
@@ -225,17 +332,42 @@ void * mmu_client_thread(void *vclient)/*{{{*/
 		case MMU_PROTO_CREATE_REQ:
 			mmu_client_create(c);
 			break;
+		case MMU_PROTO_FORK_REQ:
+			mmu_client_fork(c);
+			break;
 		case MMU_PROTO_EXTEND_REQ:
 			mmu_client_extend(c);
 			break;
+		case MMU_PROTO_EXTEND_RANGE_REQ:
+			mmu_client_extend_range(c);
+			break;
 		case MMU_PROTO_SYSLOG_REQ:
 			mmu_client_syslog(c);
 			break;
+		case MMU_PROTO_RELEASE_REQ:
+			mmu_client_release(c);
+			break;
+		case MMU_PROTO_ADVISE_REQ:
+			mmu_client_advise(c);
+			break;
+		case MMU_PROTO_LOCK_REQ:
+			mmu_client_lock(c);
+			break;
+		case MMU_PROTO_UNLOCK_REQ:
+			mmu_client_unlock(c);
+			break;
+		case MMU_PROTO_SETLIMIT_REQ:
+			mmu_client_setlimit(c);
+			break;
+		case MMU_PROTO_USAGE_REQ:
+			mmu_client_usage(c);
+			break;
 		case MMU_PROTO_SEGV_REQ:
 			mmu_client_segv(c);
 			break;
 		case MMU_PROTO_REMAP_REQ:
 		case MMU_PROTO_CHPROT_REQ:
+		case MMU_PROTO_CHPROT_VEC_REQ:
 			/* these messages are handled by the pager thread */
 			break;
 		case MMU_PROTO_EXIT_REQ:
@@ -271,8 +403,7 @@ void mmu_client_create(struct mmu_client *c)/*{{{*/
 	assert(req.type == MMU_PROTO_CREATE_REQ);
 
 	c->pid = (pid_t)req.pid;
-	int id = nextid;
-	id2pid[nextid++] = c->pid;
+	int id = pid_register(c->pid, c);
 	printf("pager_create pid %d\n", id);
 	pager_create(c->pid);
 	snprintf(msg, 96, "create pid %d", id);
@@ -282,6 +413,35 @@ void mmu_client_create(struct mmu_client *c)/*{{{*/
 	rep.type = MMU_PROTO_CREATE_REP;
 	memset(rep.pmem_fn, '\0', MMU_PROTO_PATH_MAX);
 	strncat(rep.pmem_fn, mmu->pmem_fn, MMU_PROTO_PATH_MAX);
+	rep.maxaddr = (uint64_t)UVM_MAXADDR;
+	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		goto out_client;
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
+void mmu_client_fork(struct mmu_client *c)/*{{{*/
+{
+	char msg[96];
+	struct mmu_proto_fork_req req;
+	if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+		goto out_client;
+	assert(req.type == MMU_PROTO_FORK_REQ);
+
+	c->pid = (pid_t)req.pid;
+	int id = pid_register(c->pid, c);
+	struct mmu_proto_fork_rep rep;
+	rep.type = MMU_PROTO_FORK_REP;
+	rep.retcode = pager_fork((pid_t)req.ppid, c->pid);
+	if(rep.retcode == 0) {
+		printf("pager_fork pid %d parent %d\n", id,
+				get_pid_id((pid_t)req.ppid));
+	}
+	snprintf(msg, 96, "fork pid %d retcode %d", id, (int)rep.retcode);
+	mmu_client_log(c, __func__, msg);
+
 	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
 		goto out_client;
 	return;
@@ -315,6 +475,33 @@ void mmu_client_extend(struct mmu_client *c)/*{{{*/
 	mmu_client_destroy(c);
 }/*}}}*/
 
+void mmu_client_extend_range(struct mmu_client *c)/*{{{*/
+{
+	char msg[96];
+	struct mmu_proto_extend_range_req req;
+	if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+		goto out_client;
+	assert(req.type == MMU_PROTO_EXTEND_RANGE_REQ);
+
+	int id = get_pid_id(c->pid);
+	void *vaddr = pager_extend_range(c->pid, (int)req.count);
+	printf("pager_extend_range pid %d count %u vaddr %p\n", id,
+			(unsigned)req.count, vaddr);
+	snprintf(msg, 96, "extend count %u vaddr %p", (unsigned)req.count,
+			vaddr);
+	mmu_client_log(c, __func__, msg);
+
+	struct mmu_proto_extend_range_rep rep;
+	rep.type = MMU_PROTO_EXTEND_RANGE_REP;
+	rep.vaddr = (intptr_t)vaddr;
+	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		goto out_client;
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
 void mmu_client_syslog(struct mmu_client *c)/*{{{*/
 {
 	char msg[96];
@@ -343,6 +530,185 @@ void mmu_client_syslog(struct mmu_client *c)/*{{{*/
 	mmu_client_destroy(c);
 }/*}}}*/
 
+void mmu_client_release(struct mmu_client *c)/*{{{*/
+{
+	char msg[96];
+	struct mmu_proto_release_req req;
+	if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+		goto out_client;
+	assert(req.type == MMU_PROTO_RELEASE_REQ);
+
+	assert(req.addr < UINTPTR_MAX);
+	void *vaddr = (void *)(uintptr_t)req.addr;
+	size_t len = (size_t)req.len;
+	int id = get_pid_id(c->pid);
+	printf("pager_release pid %d %p len %zu\n", id, vaddr, len);
+	int status = pager_release(c->pid, vaddr, len);
+	snprintf(msg, 96, "vaddr %p len %zu retcode %d", vaddr, len, status);
+	mmu_client_log(c, __func__, msg);
+
+	struct mmu_proto_release_rep rep;
+	rep.type = MMU_PROTO_RELEASE_REP;
+	rep.retcode = (uint32_t)status;
+	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		goto out_client;
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
+void mmu_client_advise(struct mmu_client *c)/*{{{*/
+{
+	char msg[96];
+	struct mmu_proto_advise_req req;
+	if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+		goto out_client;
+	assert(req.type == MMU_PROTO_ADVISE_REQ);
+
+	assert(req.addr < UINTPTR_MAX);
+	void *vaddr = (void *)(uintptr_t)req.addr;
+	size_t len = (size_t)req.len;
+	int advice = (int)req.advice;
+	int id = get_pid_id(c->pid);
+	printf("pager_advise pid %d %p len %zu advice %d\n", id, vaddr, len,
+			advice);
+	int status = pager_advise(c->pid, vaddr, len, advice);
+	snprintf(msg, 96, "vaddr %p len %zu advice %d retcode %d", vaddr, len,
+			advice, status);
+	mmu_client_log(c, __func__, msg);
+
+	struct mmu_proto_advise_rep rep;
+	rep.type = MMU_PROTO_ADVISE_REP;
+	rep.retcode = (uint32_t)status;
+	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		goto out_client;
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
+void mmu_client_lock(struct mmu_client *c)/*{{{*/
+{
+	char msg[96];
+	struct mmu_proto_lock_req req;
+	if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+		goto out_client;
+	assert(req.type == MMU_PROTO_LOCK_REQ);
+
+	assert(req.addr < UINTPTR_MAX);
+	void *vaddr = (void *)(uintptr_t)req.addr;
+	size_t len = (size_t)req.len;
+	int id = get_pid_id(c->pid);
+	printf("pager_lock pid %d %p len %zu\n", id, vaddr, len);
+	int status = pager_lock(c->pid, vaddr, len);
+	snprintf(msg, 96, "vaddr %p len %zu retcode %d", vaddr, len, status);
+	mmu_client_log(c, __func__, msg);
+
+	struct mmu_proto_lock_rep rep;
+	rep.type = MMU_PROTO_LOCK_REP;
+	rep.retcode = (int32_t)status;
+	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		goto out_client;
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
+void mmu_client_unlock(struct mmu_client *c)/*{{{*/
+{
+	char msg[96];
+	struct mmu_proto_unlock_req req;
+	if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+		goto out_client;
+	assert(req.type == MMU_PROTO_UNLOCK_REQ);
+
+	assert(req.addr < UINTPTR_MAX);
+	void *vaddr = (void *)(uintptr_t)req.addr;
+	size_t len = (size_t)req.len;
+	int id = get_pid_id(c->pid);
+	printf("pager_unlock pid %d %p len %zu\n", id, vaddr, len);
+	int status = pager_unlock(c->pid, vaddr, len);
+	snprintf(msg, 96, "vaddr %p len %zu retcode %d", vaddr, len, status);
+	mmu_client_log(c, __func__, msg);
+
+	struct mmu_proto_unlock_rep rep;
+	rep.type = MMU_PROTO_UNLOCK_REP;
+	rep.retcode = (uint32_t)status;
+	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		goto out_client;
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
+void mmu_client_setlimit(struct mmu_client *c)/*{{{*/
+{
+	char msg[96];
+	struct mmu_proto_setlimit_req req;
+	if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+		goto out_client;
+	assert(req.type == MMU_PROTO_SETLIMIT_REQ);
+
+	pid_t target = req.pid ? (pid_t)req.pid : c->pid;
+	unsigned long limit = (unsigned long)req.limit;
+	int id = get_pid_id(c->pid);
+	printf("pager_setlimit pid %d target %d resource %d limit %lu\n",
+			id, get_pid_id(target), (int)req.resource, limit);
+	int status = pager_setlimit(target, (int)req.resource, limit);
+	snprintf(msg, 96, "target %d resource %d retcode %d", (int)target,
+			(int)req.resource, status);
+	mmu_client_log(c, __func__, msg);
+
+	struct mmu_proto_setlimit_rep rep;
+	rep.type = MMU_PROTO_SETLIMIT_REP;
+	rep.retcode = (int32_t)status;
+	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		goto out_client;
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
+void mmu_client_usage(struct mmu_client *c)/*{{{*/
+{
+	char msg[96];
+	struct mmu_proto_usage_req req;
+	if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+		goto out_client;
+	assert(req.type == MMU_PROTO_USAGE_REQ);
+
+	pid_t target = req.pid ? (pid_t)req.pid : c->pid;
+	int id = get_pid_id(c->pid);
+	printf("pager_getusage pid %d target %d\n", id, get_pid_id(target));
+	struct uvm_usage usage;
+	memset(&usage, 0, sizeof(usage));
+	int status = pager_getusage(target, &usage);
+	snprintf(msg, 96, "target %d retcode %d", (int)target, status);
+	mmu_client_log(c, __func__, msg);
+
+	struct mmu_proto_usage_rep rep;
+	rep.type = MMU_PROTO_USAGE_REP;
+	rep.retcode = (int32_t)status;
+	rep.resident = usage.resident;
+	rep.swapped = usage.swapped;
+	rep.dirty = usage.dirty;
+	rep.faults = usage.faults;
+	rep.pages = usage.pages;
+	for(int i = 0; i < UVM_LIMIT_COUNT; i++)
+		rep.limits[i] = usage.limits[i];
+	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		goto out_client;
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
 void mmu_client_segv(struct mmu_client *c)/*{{{*/
 {
 	char msg[96];
@@ -359,10 +725,11 @@ void mmu_client_segv(struct mmu_client *c)/*{{{*/
 
 	int id = get_pid_id(c->pid);
 	printf("pager_fault pid %d vaddr %p\n", id, vaddr);
-	pager_fault(c->pid, vaddr);
+	int status = pager_fault(c->pid, vaddr);
 
 	struct mmu_proto_segv_rep rep;
 	rep.type = MMU_PROTO_SEGV_REP;
+	rep.retcode = (int32_t)status;
 	if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
 		goto out_client;
 	return;
@@ -387,7 +754,8 @@ void mmu_client_exit(struct mmu_client *c)/*{{{*/
 	rep.type = MMU_PROTO_EXIT_REP;
 	send(c->sock, &rep, sizeof(rep), 0); /* ignoring return value */
 
-	mmu->sock2client[c->sock] = NULL;
+	sock2client_set(c->sock, NULL);
+	if(c->pid) pid_unbind(c);
 	c->running = 0;
 	close(c->sock);
 	return;
@@ -400,10 +768,11 @@ void mmu_client_destroy(struct mmu_client *c)/*{{{*/
 {
 	loge(LOG_WARN, __FILE__, __LINE__);
 	mmu_client_log(c, __func__, "running");
-	mmu->sock2client[c->sock] = NULL;
+	sock2client_set(c->sock, NULL);
 	c->running = 0;
 	close(c->sock);
 	if(c->pid) { /* may get here before CREATE_REQ happens */
+		pid_unbind(c);
 		pager_destroy(c->pid);
 	}
 }/*}}}*/
@@ -414,10 +783,11 @@ void mmu_client_destroy(struct mmu_client *c)/*{{{*/
  ***************************************************************************/
 struct mmu_client * mmu_client_search(pid_t pid)/*{{{*/
 {
-	for(int i = 3; i < MMU_MAX_SOCK; ++i) {
-		if(!mmu->sock2client[i]) continue;
-		if(mmu->sock2client[i]->pid == pid) return mmu->sock2client[i];
-	}
+	pthread_rwlock_rdlock(&pid_lock);
+	struct mmu_pid_slot *slot = pid_slot(pid);
+	struct mmu_client *c = slot->pid == pid ? slot->client : NULL;
+	pthread_rwlock_unlock(&pid_lock);
+	if(c) return c;
 	printf("error: pid %d not found.  aborting.\n", (int)pid);
 	logd(LOG_FATAL, "pid %d not found.  aborting.\n", (int)pid);
 	mmu_destroy();
@@ -528,6 +898,41 @@ void mmu_chprot(pid_t pid, void *vaddr, int prot)/*{{{*/
 	mmu_client_destroy(c);
 }/*}}}*/
 
+void mmu_chprot_vec(pid_t pid, void **vaddrs, int count, int prot)/*{{{*/
+{
+	int id = get_pid_id(pid);
+	printf("%s pid %d count %d prot %d\n", __func__, id, count, prot);
+	logd(LOG_DEBUG, "%s pid %d count %d prot %d\n", __func__,
+			id, count, prot);
+	struct mmu_client *c = mmu_client_search(pid);
+	for(int i = 0; i < count; i += MMU_PROTO_CHPROT_VEC_MAX) {
+		struct mmu_proto_chprot_vec_rep rep;
+		rep.type = MMU_PROTO_CHPROT_VEC_REP;
+		rep.prot = (int32_t)prot;
+		rep.count = count - i;
+		if(rep.count > MMU_PROTO_CHPROT_VEC_MAX)
+			rep.count = MMU_PROTO_CHPROT_VEC_MAX;
+		for(uint32_t j = 0; j < rep.count; ++j)
+			rep.vaddr[j] = (intptr_t)vaddrs[i + j];
+		if(send(c->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+			goto out_client;
+
+		uint32_t t;
+		do {
+			if(recv(c->sock, &t, sizeof(t), MSG_PEEK) != sizeof(t))
+				goto out_client;
+		} while(t != MMU_PROTO_CHPROT_VEC_REQ);
+		struct mmu_proto_chprot_vec_req req;
+		if(recv(c->sock, &req, sizeof(req), 0) != sizeof(req))
+			goto out_client;
+		assert(req.type == MMU_PROTO_CHPROT_VEC_REQ);
+	}
+	return;
+
+	out_client:
+	mmu_client_destroy(c);
+}/*}}}*/
+
 void mmu_disk_read(int block_from, int frame_to)/*{{{*/
 {
 	printf("%s from block %d to frame %d\n", __func__,
@@ -547,6 +952,23 @@ void mmu_disk_write(int frame_from, int block_to)/*{{{*/
 	memcpy(mmu->disk + block_to*PAGESIZE, mmu->pmem + frame_from*PAGESIZE,
 			PAGESIZE);
 }/*}}}*/
+
+void mmu_copy_frame(int frame_from, int frame_to)/*{{{*/
+{
+	printf("%s from frame %d to frame %d\n", __func__,
+			frame_from, frame_to);
+	logd(LOG_DEBUG, "%s from frame %d to frame %d\n", __func__,
+			frame_from, frame_to);
+	memcpy(mmu->pmem + frame_to*PAGESIZE, mmu->pmem + frame_from*PAGESIZE,
+			PAGESIZE);
+}/*}}}*/
+
+void mmu_load_frame(const char *data, int frame_to)/*{{{*/
+{
+	printf("%s to frame %d\n", __func__, frame_to);
+	logd(LOG_DEBUG, "%s to frame %d\n", __func__, frame_to);
+	memcpy(mmu->pmem + frame_to*PAGESIZE, data, PAGESIZE);
+}/*}}}*/
 /*}}}*/
 
 /****************************************************************************
@@ -556,25 +978,75 @@ void mmu_disk_write(int frame_from, int block_to)/*{{{*/
 void pager_free(void);
 #endif
 void usage(int argc, char **argv) {/*{{{*/
-	printf("usage: %s NFRAMES NBLOCKS\n", argv[0]);
+	printf("usage: %s NFRAMES NBLOCKS [KEY=VALUE ...]\n", argv[0]);
+	printf("\n");
+	printf("valid ranges: 2 <= NFRAMES, 2 <= NBLOCKS\n");
+	printf("              vmsize=BYTES[K|M|G] (default 1M) sets the\n");
+	printf("              virtual memory each process can allocate\n");
 	printf("\n");
-	printf("valid ranges: 2 <= NFRAMES <= 256\n");
-	printf("              4 <= NBLOCKS <= 1024\n");
+	printf("options: policy=clock|lru|clockpro|2q|arc|nru\n");
+	printf("         lowmark=N highmark=M\n");
+	printf("         pff=T readahead=N faultaround=K (K <= 64) dedup=MS\n");
+	printf("         writeback=0|1 chprotvec=0|1 zeropage=0|1 zswap=N\n");
+	printf("         swapcache=0|1 overcommit=strict|ratio|unlimited\n");
+	printf("         commitratio=PCT\n");
+	printf("         pinlimit=N maxresident=N maxswap=N maxpages=N\n");
+	printf("         magazine=N stats=0|1\n");
 	exit(EXIT_FAILURE);
 }/*}}}*/
 
+/* Parses the `vmsize` option: the managed window becomes
+ * `UVM_BASEADDR` up to `UVM_BASEADDR + size - 1`.  The size must be a
+ * positive multiple of the page size written as a decimal number with
+ * no sign, and the window must end below 2^47 (the user address space
+ * of x86-64).  The limit is checked before the K, M or G suffix is
+ * applied, so large values cannot wrap around. */
+int mmu_set_vmsize(const char *value) {/*{{{*/
+	const unsigned long long limit = (1ULL << 47) - UVM_BASEADDR;
+	char *end;
+	int shift = 0;
+	if(*value < '0' || *value > '9') return -1;
+	errno = 0;
+	unsigned long long size = strtoull(value, &end, 10);
+	if(errno != 0) return -1;
+	if(*end == 'K' || *end == 'k') shift = 10, end++;
+	else if(*end == 'M' || *end == 'm') shift = 20, end++;
+	else if(*end == 'G' || *end == 'g') shift = 30, end++;
+	if(*end != '\0' || size > (limit >> shift)) return -1;
+	size <<= shift;
+	long pagesz = sysconf(_SC_PAGESIZE);
+	if(size == 0 || size % pagesz != 0) return -1;
+	uvm_maxaddr = UVM_BASEADDR + (intptr_t)size - 1;
+	return 0;
+}/*}}}*/
+
 int main(int argc, char **argv) {/*{{{*/
-	if(argc != 3) usage(argc, argv);
+	if(argc < 3) usage(argc, argv);
 	int npages = atoi(argv[1]);
-	if(npages < 1 || npages > 256) usage(argc, argv);
+	if(npages < 2) usage(argc, argv);
 	int nblocks = atoi(argv[2]);
-	if(nblocks < 2 || nblocks > 1024) usage(argc, argv);
+	if(nblocks < 2) usage(argc, argv);
 	#ifdef MMULOG
 	log_init(LOG_EXTRA, "mmu.log", 1, 1<<20);
 	#endif
-	memset(id2pid, 255, UINT8_MAX * sizeof(pid_t));
+	for(int i = 3; i < argc; ++i) {
+		char *value = strchr(argv[i], '=');
+		if(!value) usage(argc, argv);
+		*value++ = '\0';
+		if(!strcmp(argv[i], "vmsize")) {
+			if(mmu_set_vmsize(value)) usage(argc, argv);
+			continue;
+		}
+		if(pager_setopt(argv[i], value)) usage(argc, argv);
+	}
 	mmu_init(npages, nblocks);
+	/* Pager threads must not receive SIGINT (see `mmu_accept_loop`). */
+	sigset_t sigint;
+	sigemptyset(&sigint);
+	sigaddset(&sigint, SIGINT);
+	pthread_sigmask(SIG_BLOCK, &sigint, NULL);
 	pager_init(npages, nblocks);
+	pthread_sigmask(SIG_UNBLOCK, &sigint, NULL);
 	mmu_accept_loop();
 	#ifdef MMUFREE
 	pager_free();
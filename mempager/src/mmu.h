@@ -5,6 +5,8 @@
 #ifndef __MMU_HEADER__
 #define __MMU_HEADER__
 
+#include <stdint.h>
+
 /* `UVM_BASEADDR` is where virtual pages will be mapped in process
  * virtual address spaces.  This address is not normally used by the
  * Linux kernel.  The page size for the architecture can be obtained
@@ -14,10 +16,14 @@
 #define UVM_BASEADDR ((intptr_t)0x60000000)
 
 /* Programs can allocate a maximum of 1MiB (256 4KiB pages) in the
- * infrastructure; the maximum address managed by the MMU is
- * `UVM_MAXADDR`.  Only faults for addresses between `UVM_BASEADDR`
- * and `UVM_MAXADDR` are sent to the pager. */
-#define UVM_MAXADDR ((intptr_t)0x600FFFFF)
+ * infrastructure by default; the MMU option `vmsize=BYTES` changes
+ * this at startup, and `uvm_create` learns it from the MMU.  The
+ * maximum address managed by the MMU is `UVM_MAXADDR`.  Only faults
+ * for addresses between `UVM_BASEADDR` and `UVM_MAXADDR` are sent to
+ * the pager. */
+#define UVM_DEFAULT_MAXADDR ((intptr_t)0x600FFFFF)
+extern intptr_t uvm_maxaddr;
+#define UVM_MAXADDR uvm_maxaddr
 
 /* `pmem` points to the physical memory maintained by the MMU.  Your
  * pager should never write to `pmem`.  */
@@ -49,6 +55,12 @@ void mmu_nonresident(pid_t pid, void *vaddr);
  * on `vaddr` and `prot`.  */
 void mmu_chprot(pid_t pid, void *vaddr, int prot);
 
+/* `mmu_chprot_vec` will change access permissions for the `count`
+ * pages of process `pid` starting at the addresses in `vaddrs` to
+ * `prot`, with one message (and one acknowledgement) per
+ * `MMU_PROTO_CHPROT_VEC_MAX` pages.  See `mmu_chprot` above. */
+void mmu_chprot_vec(pid_t pid, void **vaddrs, int count, int prot);
+
 /* `mmu_disk_read` copies content from disk block `block_from` into
  * physical frame `frame_to`.  `mmu_disk_write` copies content from
  * frame `frame_from` to disk block `block_to`.  Your pager shoudl
@@ -56,4 +68,15 @@ void mmu_chprot(pid_t pid, void *vaddr, int prot);
 void mmu_disk_read(int block_from, int frame_to);
 void mmu_disk_write(int frame_from, int block_to);
 
+/* `mmu_copy_frame` copies content from physical frame `frame_from`
+ * into physical frame `frame_to`.  The pager uses it to give a
+ * process its own copy of a frame shared after `pager_fork`.  */
+void mmu_copy_frame(int frame_from, int frame_to);
+
+/* `mmu_load_frame` copies one page of content from `data`, a buffer
+ * owned by the pager, into physical frame `frame_to`.  The pager uses
+ * it to swap in pages kept outside the disk (e.g., compressed in
+ * memory), since it should never write to `pmem` directly.  */
+void mmu_load_frame(const char *data, int frame_to);
+
 #endif
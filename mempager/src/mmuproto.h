@@ -12,18 +12,46 @@
  * The `CREATE` message and its reply are exchanged before the
  * `vmu_thread` starts.  Clients send their PID to the MMU, and
  * receive the path to the memory-mapped file representing physical
- * memory.
+ * memory and the last address managed by the MMU (`UVM_MAXADDR`).
+ *
+ * The `FORK` message replaces `CREATE` in children created by
+ * `uvm_fork`.  The child sends its PID and its parent's PID; the
+ * MMU replies after the pager has shared the parent's pages with
+ * the child.  Until the reply arrives, the child also processes the
+ * `REMAP` and `CHPROT` messages it may receive in the meantime.
  *
  * The `EXTEND` and `SEGV` messages are generated by the client when
  * they allocate memory and experience a segmentation fault,
  * respectively.  The request functions (`uvm_extend` and
  * `uvm_segv_action`) wait on a condition variable for the request
- * to be serviced.
+ * to be serviced.  A `SEGV` reply with a nonzero `retcode` means the
+ * pager ran out of swap space and the client exits.
+ *
+ * The `EXTEND_RANGE` message is an `EXTEND` for `count` pages, sent by
+ * `uvm_extend_n`.  The reply carries the address of the first page
+ * of a contiguous range, or zero if no page was allocated.
+ *
+ * The `RELEASE` message is sent by `uvm_release` and is serviced like
+ * a `SYSLOG`: the MMU may send `CHPROT` messages that unmap the
+ * released pages before replying.  The `ADVISE` message is sent by
+ * `uvm_advise` and is serviced the same way, as are the `LOCK` and
+ * `UNLOCK` messages sent by `uvm_lock` and `uvm_unlock`.  The `LOCK`
+ * reply carries -1 for an invalid range and -2 when the pages could
+ * not be pinned.
+ *
+ * The `SETLIMIT` and `USAGE` messages are sent by `uvm_setlimit` and
+ * `uvm_getusage`.  They name a target process (0 for the sender),
+ * which need not be the sender.  The `SETLIMIT` reply carries -1 for
+ * an unknown resource and -2 for an unknown process; the `USAGE`
+ * reply carries the counters of `struct uvm_usage`, or a nonzero
+ * `retcode` for an unknown process.
  *
  * The `REMAP` and `CHPROT` messages are generated by the MMU and
  * are processed by `uvm_thread` asynchronously.  These messages are
  * used to service sergmentation faults and whenever the pager pages
- * some of the processes pages to disk. */
+ * some of the processes pages to disk.  The `CHPROT_VEC` message is
+ * a `CHPROT` covering up to `MMU_PROTO_CHPROT_VEC_MAX` pages of the
+ * same process, acknowledged once. */
 
 #ifndef __MMUPROTO_HEADER__
 #define __MMUPROTO_HEADER__
@@ -44,6 +72,24 @@
 #define MMU_PROTO_REMAP_REP 10
 #define MMU_PROTO_CHPROT_REQ 11
 #define MMU_PROTO_CHPROT_REP 12
+#define MMU_PROTO_CHPROT_VEC_REQ 13
+#define MMU_PROTO_CHPROT_VEC_REP 14
+#define MMU_PROTO_FORK_REQ 15
+#define MMU_PROTO_FORK_REP 16
+#define MMU_PROTO_EXTEND_RANGE_REQ 17
+#define MMU_PROTO_EXTEND_RANGE_REP 18
+#define MMU_PROTO_RELEASE_REQ 19
+#define MMU_PROTO_RELEASE_REP 20
+#define MMU_PROTO_ADVISE_REQ 21
+#define MMU_PROTO_ADVISE_REP 22
+#define MMU_PROTO_LOCK_REQ 23
+#define MMU_PROTO_LOCK_REP 24
+#define MMU_PROTO_UNLOCK_REQ 25
+#define MMU_PROTO_UNLOCK_REP 26
+#define MMU_PROTO_SETLIMIT_REQ 27
+#define MMU_PROTO_SETLIMIT_REP 28
+#define MMU_PROTO_USAGE_REQ 29
+#define MMU_PROTO_USAGE_REP 30
 #define MMU_PROTO_EXIT_REQ 32
 #define MMU_PROTO_EXIT_REP 33
 
@@ -54,6 +100,17 @@ struct mmu_proto_create_req {
 struct mmu_proto_create_rep {
 	uint32_t type;
 	char pmem_fn[MMU_PROTO_PATH_MAX];
+	uint64_t maxaddr;
+} __attribute__((packed));
+
+struct mmu_proto_fork_req {
+	uint32_t type;
+	uint32_t pid;
+	uint32_t ppid;
+} __attribute__((packed));
+struct mmu_proto_fork_rep {
+	uint32_t type;
+	int32_t retcode;
 } __attribute__((packed));
 
 struct mmu_proto_extend_req {
@@ -64,6 +121,15 @@ struct mmu_proto_extend_rep {
 	uint64_t vaddr;
 } __attribute__((packed));
 
+struct mmu_proto_extend_range_req {
+	uint32_t type;
+	uint32_t count;
+} __attribute__((packed));
+struct mmu_proto_extend_range_rep {
+	uint32_t type;
+	uint64_t vaddr;
+} __attribute__((packed));
+
 struct mmu_proto_syslog_req {
 	uint32_t type;
 	uint32_t len;
@@ -74,6 +140,73 @@ struct mmu_proto_syslog_rep {
 	uint32_t retcode;
 } __attribute__((packed));
 
+struct mmu_proto_release_req {
+	uint32_t type;
+	uint32_t len;
+	uint64_t addr;
+} __attribute__((packed));
+struct mmu_proto_release_rep {
+	uint32_t type;
+	uint32_t retcode;
+} __attribute__((packed));
+
+struct mmu_proto_advise_req {
+	uint32_t type;
+	int32_t advice;
+	uint32_t len;
+	uint64_t addr;
+} __attribute__((packed));
+struct mmu_proto_advise_rep {
+	uint32_t type;
+	uint32_t retcode;
+} __attribute__((packed));
+
+struct mmu_proto_lock_req {
+	uint32_t type;
+	uint32_t len;
+	uint64_t addr;
+} __attribute__((packed));
+struct mmu_proto_lock_rep {
+	uint32_t type;
+	int32_t retcode;
+} __attribute__((packed));
+
+struct mmu_proto_unlock_req {
+	uint32_t type;
+	uint32_t len;
+	uint64_t addr;
+} __attribute__((packed));
+struct mmu_proto_unlock_rep {
+	uint32_t type;
+	uint32_t retcode;
+} __attribute__((packed));
+
+struct mmu_proto_setlimit_req {
+	uint32_t type;
+	uint32_t pid;
+	int32_t resource;
+	uint64_t limit;
+} __attribute__((packed));
+struct mmu_proto_setlimit_rep {
+	uint32_t type;
+	int32_t retcode;
+} __attribute__((packed));
+
+struct mmu_proto_usage_req {
+	uint32_t type;
+	uint32_t pid;
+} __attribute__((packed));
+struct mmu_proto_usage_rep {
+	uint32_t type;
+	int32_t retcode;
+	uint64_t resident;
+	uint64_t swapped;
+	uint64_t dirty;
+	uint64_t faults;
+	uint64_t pages;
+	uint64_t limits[3];
+} __attribute__((packed));
+
 struct mmu_proto_segv_req {
 	uint32_t type;
 	int32_t code;
@@ -81,6 +214,7 @@ struct mmu_proto_segv_req {
 } __attribute__((packed));
 struct mmu_proto_segv_rep {
 	uint32_t type;
+	int32_t retcode;
 } __attribute__((packed));
 // segv causes remap and chprot to happen
 
@@ -103,6 +237,17 @@ struct mmu_proto_chprot_rep {
 	uint64_t vaddr;
 } __attribute__((packed));
 
+#define MMU_PROTO_CHPROT_VEC_MAX 64
+struct mmu_proto_chprot_vec_req {
+	uint32_t type;
+} __attribute__((packed));
+struct mmu_proto_chprot_vec_rep {
+	uint32_t type;
+	int32_t prot;
+	uint32_t count;
+	uint64_t vaddr[MMU_PROTO_CHPROT_VEC_MAX];
+} __attribute__((packed));
+
 struct mmu_proto_exit_req {
 	uint32_t type;
 } __attribute__((packed));
@@ -1,65 +1,144 @@
 #include "pager.h"
 #include "mmu.h"
+#include "uvm.h"
 
 #include <stdlib.h>
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <sys/mman.h>
 #include <pthread.h>
+#include <stdint.h>
+#include <sched.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-#define PAGE_SIZE sysconf(_SC_PAGESIZE)
-#define NUM_PAGES (UVM_MAXADDR - UVM_BASEADDR + 1) / PAGE_SIZE
+#define PAGE_SIZE pager_page_size
+#define NUM_PAGES pager_num_pages
 #define NO_ALLOC 0
 
+/**
+ * @brief Tamanho das páginas do sistema e quantidade de páginas entre UVM_BASEADDR e UVM_MAXADDR, calculados uma única vez em
+ * "pager_init" (o fim da janela é definido pela opção vmsize da MMU).
+ * 
+ */
+long pager_page_size;
+long pager_num_pages;
+
 
 #define VIRTUAL_ADDR_TO_INDEX(vaddr) (long) (((long) vaddr - UVM_BASEADDR) / PAGE_SIZE)
-#define INDEX_TO_VIRTUAL_ADDR(idx) (void*) (UVM_BASEADDR + (idx * PAGE_SIZE))
+#define INDEX_TO_VIRTUAL_ADDR(idx) (void*) (UVM_BASEADDR + ((idx) * PAGE_SIZE))
 #define NORM_VIRTUAL_ADDR(vaddr) INDEX_TO_VIRTUAL_ADDR(VIRTUAL_ADDR_TO_INDEX(vaddr))
 
-/**
- * @brief Mutex utilizado para evitar condições de corrida entre acessos de processos diferentes
- * 
- */
-pthread_mutex_t lock;
-//----------------------------- PAGE CENTRAL----------------------------------------------------------
+//----------------------------- PAGE TABLE ENTRY ------------------------------------------------------
 
 /**
  * @brief Estrutura utilizada para guardar os bits de informações de acesso da página, sendo úteis para o algoritmo de segunda chance.
  * @param write_op Indica se já ocorreu uma operação de escrita na página no passado,
  * @param permission Armazena as permissões atuais da página, indicando se é possível ler e escrever nela, por exemplo.
  * @param reference_bit Bit utilizado no algoritmo de segunda chance para definir a pagina retirada da mêmoria.
+ * @param dirty Indica que o conteúdo do quadro pode diferir do bloco reservado no disco. Só é zerado pela escrita em segundo plano
+ * (opção writeback=1) e pela leitura do bloco (opção swapcache=1); sem elas, acompanha "write_op".
+ * @param prefetched Indica que a página foi lida do disco antecipadamente (opção readahead) e ainda não foi mapeada no processo.
+ * @param cow Indica que o quadro ou o bloco da página podem estar compartilhados com outro processo após "pager_fork". A primeira
+ * escrita cria cópias privadas (ver "cow_break").
+ * @param zero Indica que a página, ainda sem conteúdo (PAGE_EXTENDED), está mapeada com permissão de leitura no quadro de zeros
+ * compartilhado "zero_frame" (opção zeropage=1).
+ * @param advice Padrão de acesso informado por "pager_advise" (UVM_ADV_NORMAL, UVM_ADV_SEQUENTIAL ou UVM_ADV_RANDOM).
+ * @param cold Indica que a página, presente na memória principal, está na fila de vítimas preferenciais (ver "cold_mark").
+ * @param pinned Indica que a página foi fixada na memória principal por "pager_lock": seu quadro não é candidato à substituição, e
+ * suas permissões não são retiradas (ver "frame_pinned"). Só é alterado com "frame_lock" adquirido.
  * 
  */
 typedef struct{
     short write_op;
     short permission;
     short reference_bit;
+    short dirty;
+    short prefetched;
+    short cow;
+    short zero;
+    short advice;
+    short cold;
+    short pinned;
 } bits_array;
 
 /**
- * @brief Representa uma página da memória virtual.
+ * @brief Estados possíveis de uma entrada da tabela de páginas de um processo.
+ * PAGE_UNUSED - A página não foi solicitada pelo processo.
+ * PAGE_EXTENDED - A página foi solicitada via "pager_extend", mas não possui conteúdo guardado (será preenchida com zeros no próximo acesso).
+ * PAGE_IN_FRAME - A página está presente na memória principal, no quadro "frame".
+ * PAGE_IN_BLOCK - A página está presente apenas no disco, no bloco "block" reservado para ela.
+ * 
+ */
+#define PAGE_UNUSED 0
+#define PAGE_EXTENDED 1
+#define PAGE_IN_FRAME 2
+#define PAGE_IN_BLOCK 3
+
+/**
+ * @brief Entrada da tabela de páginas de um processo. Reúne em um único lugar o estado da página, sua localização
+ * (quadro ou bloco) e os bits de acesso, de forma que uma única consulta à tabela responde a uma falha de página.
+ * @param state Estado da página (PAGE_UNUSED, PAGE_EXTENDED, PAGE_IN_FRAME ou PAGE_IN_BLOCK).
+ * @param options Bits de acesso da página (escrita, permissão e referência).
+ * @param frame Quadro da memória principal ocupado pela página, ou -1.
+ * @param block Bloco do disco reservado para a página em "pager_extend" (ou, com a opção overcommit, na primeira retirada da página
+ * já escrita), ou -1.
+ * @param ghost Lista fantasma da política de substituição em que a página foi registrada ao sair da memória principal, ou 0.
+ * @param ghost_seq Número de sequência do registro na lista fantasma.
+ * 
+ */
+typedef struct{
+    short state;
+    bits_array options;
+    int frame;
+    int block;
+    short ghost;
+    unsigned int ghost_seq;
+} page_entry;
+
+//----------------------------- PAGE CENTRAL----------------------------------------------------------
+
+/**
+ * @brief Representa o ocupante de uma posição da memória principal ou do disco (mapeamento reverso).
  * @param pid Especifica o processo que originou essa página.
- * @param options Define as opções da página (permissões, etc...)
  * @param vaddr Endereço virtual inicial da página
+ * @param entry Entrada da tabela de páginas do processo que descreve essa página.
  * 
  */
 typedef struct{
     pid_t pid;
-    bits_array options;
     void* vaddr;
+    page_entry* entry;
 } page;
 
 /**
  * @brief Estrutura que abriga várias páginas para a tradução pela MMU (Memory Management Unit).
  * @param page_t Conjunto de páginas pertencentes à tabela de página.
  * @param size Quantidade de páginas detidas pela tabela.
- * @param free Determina quantas páginas estão livres.
+ * @param free Determina quantas páginas estão livres, incluindo as guardadas nos magazines (ver "page_magazine"). Atualizado de
+ * forma atômica.
+ * @param free_map Mapa de bits das posições livres, com 64 posições por palavra (bit 1 indica posição livre).
+ * @param words Quantidade de palavras de "free_map".
+ * @param hint Menor palavra de "free_map" que pode conter uma posição livre; as palavras anteriores estão todas ocupadas.
+ * @param summary Mapa de bits das palavras de "free_map" que contêm alguma posição livre (bit 1), com 64 palavras por palavra.
+ * Permite encontrar uma posição livre examinando 1/4096 das posições, mesmo em tabelas com dezenas de milhares de posições.
+ * @param summary_words Quantidade de palavras de "summary".
  * 
  */
 typedef struct{
     page* page_t;
     int size;
     int free;
+    uint64_t* free_map;
+    int words;
+    int hint;
+    uint64_t* summary;
+    int summary_words;
 } page_central;
 
 /**
@@ -77,6 +156,58 @@ page_central block;
  * 
  */
 int sc_ptr;
+/**
+ * @brief Protege a tabela "frame" (ocupantes e mapa de bits), o ponteiro "sc_ptr" e o estado da política de substituição.
+ * Nunca é mantido durante chamadas à MMU. Uma thread que detém um processo o adquire com "frame_lock_process".
+ * 
+ */
+pthread_mutex_t frame_lock;
+/**
+ * @brief Protege a tabela "block". Quando necessário junto de "frame_lock", é adquirido depois dele.
+ * 
+ */
+pthread_mutex_t block_lock;
+/**
+ * @brief Modos de compromisso de blocos (opção overcommit).
+ * OVERCOMMIT_STRICT - Cada página recebe seu bloco em "pager_extend", que falha quando não há blocos livres (padrão).
+ * OVERCOMMIT_RATIO - As páginas solicitadas são limitadas a "block.size" mais "overcommit_ratio"% de "frame.size".
+ * OVERCOMMIT_UNLIMITED - As páginas solicitadas são limitadas apenas pelo espaço de endereçamento.
+ * Nos dois últimos modos, o bloco de uma página só é reservado quando ela é retirada da memória principal depois de escrita
+ * (ver "swap_assign").
+ * 
+ */
+#define OVERCOMMIT_STRICT 0
+#define OVERCOMMIT_RATIO 1
+#define OVERCOMMIT_UNLIMITED 2
+int overcommit_mode;
+/**
+ * @brief Porcentagem de "frame.size" somada a "block.size" no limite do modo OVERCOMMIT_RATIO (opção commitratio).
+ * 
+ */
+int overcommit_ratio = 100;
+/**
+ * @brief Quantidade de páginas solicitadas por todos os processos, fora do modo OVERCOMMIT_STRICT. Protegido por "block_lock".
+ * 
+ */
+long committed_pages;
+/**
+ * @brief Limite de páginas fixadas por processo (opção pinlimit=N). Com 0 (padrão), "pager_init" o define como 1/4 dos quadros.
+ * 
+ */
+int pin_limit;
+/**
+ * @brief Quantidade de páginas fixadas que ocupam um quadro próprio, somando todos os processos, protegida por "frame_lock". Nunca
+ * ultrapassa metade dos quadros, de forma que a substituição sempre encontra vítimas. As páginas fixadas mapeadas no quadro de
+ * zeros não contam (ver "pinned_zero").
+ * 
+ */
+int pinned_total;
+/**
+ * @brief Limites com que cada processo é criado, indexados pelas constantes UVM_LIMIT_* (opções maxresident, maxswap e maxpages).
+ * Com 0 (padrão) não há limite. Ver "pager_setlimit".
+ * 
+ */
+unsigned long default_limits[UVM_LIMIT_COUNT];
 /**
  * @brief Inicializa as páginas presentes em "page_t" com valores iniciais quaisquer
  * 
@@ -86,519 +217,4629 @@ void init_page_central(page_central *central){
     for(int i = 0 ;i < central->size; i++){
         central->page_t[i].pid = -1;
         central->page_t[i].vaddr = NO_ALLOC;
-        central->page_t[i].options.write_op = 0;
-        central->page_t[i].options.permission = PROT_NONE;
+        central->page_t[i].entry = NULL;
+    }
+
+    central->words = (central->size + 63) / 64;
+    central->free_map = (uint64_t*) calloc(central->words, sizeof(uint64_t));
+    central->hint = 0;
+    for(int i = 0; i < central->size; i++){
+        central->free_map[i / 64] |= (uint64_t) 1 << (i % 64);
+    }
+    central->summary_words = (central->words + 63) / 64;
+    central->summary = (uint64_t*) calloc(central->summary_words, sizeof(uint64_t));
+    for(int w = 0; w < central->words; w++){
+        central->summary[w / 64] |= (uint64_t) 1 << (w % 64);
     }
 }
 
 /**
- * @brief Verifica se, dado um "pid" e um "vaddr", a página de memória relativa a essas informações está presente na tabela informada.
+ * @brief Guarda uma página na posição informada da tabela, atualizando a entrada da tabela de páginas do processo.
  * 
- * @param central Tabela de páginas que se está buscando a página relativa ao processo.
- * @param pid Identificador do processo que detém a página de memória
- * @param vaddr Endereço virtual inicial relativo à página de memória
- * @param pos Ponteiro que armazenará a posição relativa à página de memória na tabela de páginas
- * @return int 0 - Indica que a página buscada não está presente na tabela. 1 - Indica que a página está na tabela.
+ * @param central Tabela onde a página será guardada ("frame" ou "block")
+ * @param pos Posição da tabela, que deve estar vazia
+ * @param new_page Página a ser guardada
  */
-int check_page_allocation(page_central* central, pid_t pid, void* vaddr, int* pos){
-    if(central->free == central->size){
-        return 0;
+void place_page(page_central* central, int pos, page new_page){
+    central->page_t[pos] = new_page;
+    if(central == &frame){
+        new_page.entry->frame = pos;
     }
-
-    for(int i = 0; i < central->size; i++){
-        if(central->page_t[i].pid == pid && central->page_t[i].vaddr == vaddr){
-            *pos = i;
-            return 1;
-        }
+    else{
+        new_page.entry->block = pos;
     }
-    *pos = -1; 
-    return 0;
 }
 
+/**
+ * @brief Desaloca a página presente na posição informada da tabela, deixando a posição livre para que outros processos
+ * possam alocar uma nova página.
+ * 
+ * @param central Tabela de páginas
+ * @param block_pos Posição a ser liberada
+ */
 void clean_page(page_central* central,int block_pos){
+    page_entry* entry = central->page_t[block_pos].entry;
+    if(entry != NULL){
+        if(central == &frame){
+            entry->frame = -1;
+        }
+        else{
+            entry->block = -1;
+        }
+    }
     central->page_t[block_pos].pid = -1;
     central->page_t[block_pos].vaddr = NO_ALLOC;
-    central->page_t[block_pos].options.write_op = 0;
-    central->page_t[block_pos].options.permission = 0;
-    central->page_t[block_pos].options.reference_bit = 0;
+    central->page_t[block_pos].entry = NULL;
 }
 
-//-------------------------- VIRTUAL MEMORY ---------------------------------------------------------------------
-
 /**
- * @brief Estrutura para identificar quais páginas um determinado processo solicitou a alocação para ele, sem necessariamente utilizá-las.
- * Essa é uma estrutura intermediária, de forma que quando um processo faz a chamada de "pager_extend()", a "virtual_memory" armazena a solicitação
- * de extensão daquele processo, evitando um "page_fault" em uma possível tentativa de acesso futura.
- * Vale ressaltar que é *memória virtual*, então diversos processos podem compartilhar a mesma posição de página.
- * @param pid Identificador do processo que detem essa memória virtual
- * @param pages Vetor de posições cuja alocação das páginas foi solicitada pelo processo
- * @param page_ptr Posição do vetor "pages", que contém a última página que teve a alocação solicitada pelo processo
+ * @brief Conta quantos bits menos significativos iguais a 0 precedem o primeiro bit 1 da palavra (que não pode ser 0).
  * 
+ * @param word Palavra do mapa de bits
+ * @return int Posição do bit 1 menos significativo
  */
-typedef struct{
-    pid_t pid;
-    int* pages;
-    int page_ptr;
-} virtual_memory;
+static inline int count_trailing_zeros(uint64_t word){
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int count = 0;
+    while((word & 1) == 0){
+        word >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
 
 /**
- * @brief Lista encadeada de memórias virtuais dos processos.
- * @param head Célula inicial da lista encadeada, contendo o primeiro processo que solicitou alocação.
- * @param tail Célula final da lista encadeada, contendo o último processo que solicitou alocação.
- * @param size Tamanho da lista
+ * @brief Busca a posição livre de menor índice na tabela, a partir da palavra "hint" do mapa de bits. Quando ela está ocupada, a
+ * próxima palavra com posições livres é encontrada no resumo "summary"; quando disponível, o SSE2 é utilizado para descartar duas
+ * palavras do resumo totalmente ocupadas por comparação. As palavras encontradas são resolvidas com a contagem de zeros à direita.
  * 
+ * @param central Tabela ("frame" ou "block")
+ * @return int A posição livre de menor índice, ou -1 caso a tabela esteja cheia.
  */
-typedef struct{
-    struct vm_node* head;
-    struct vm_node* tail;
-    int size;
-} vm_list;
+int page_central_find_free(page_central* central){
+    int w = central->hint;
+    if(w < central->words && central->free_map[w] != 0){
+        return w * 64 + count_trailing_zeros(central->free_map[w]);
+    }
+    int sw = w / 64;
+    uint64_t bits = sw < central->summary_words ? central->summary[sw] & (~(uint64_t) 0 << (w % 64)) : 0;
+    if(bits == 0){
+        sw++;
+#ifdef __SSE2__
+        const __m128i zero = _mm_setzero_si128();
+        for(; sw + 1 < central->summary_words; sw += 2){
+            __m128i chunk = _mm_loadu_si128((const __m128i*) &central->summary[sw]);
+            if(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero)) != 0xFFFF){
+                break;
+            }
+        }
+#endif
+        while(sw < central->summary_words && central->summary[sw] == 0){
+            sw++;
+        }
+        if(sw >= central->summary_words){
+            central->hint = central->words;
+            return -1;
+        }
+        bits = central->summary[sw];
+    }
+    w = sw * 64 + count_trailing_zeros(bits);
+    central->hint = w;
+    return w * 64 + count_trailing_zeros(central->free_map[w]);
+}
 
 /**
- * @brief Célula da lista encadeada.
- * @param data O conteúdo da célula, que abriga as informações de memória virtual do processo que solicitou a alocação de alguma página.
- * @param next A célula seguinte da lista encadeada.
+ * @brief Marca a posição como ocupada no mapa de bits e no resumo, sem alterar "free".
  * 
+ * @param central Tabela ("frame" ou "block")
+ * @param pos Posição livre
  */
-struct vm_node{
-    virtual_memory data;
-    struct vm_node* next;
-};
+void page_central_claim(page_central* central, int pos){
+    int w = pos / 64;
+    central->free_map[w] &= ~((uint64_t) 1 << (pos % 64));
+    if(central->free_map[w] == 0){
+        central->summary[w / 64] &= ~((uint64_t) 1 << (w % 64));
+    }
+}
 
 /**
- * @brief Variável única de gerenciamento das solicitações de alocação de página
+ * @brief Marca a posição como livre no mapa de bits e no resumo, sem alterar "free".
  * 
+ * @param central Tabela ("frame" ou "block")
+ * @param pos Posição ocupada
  */
-vm_list* manager;
+void page_central_unclaim(page_central* central, int pos){
+    central->free_map[pos / 64] |= (uint64_t) 1 << (pos % 64);
+    central->summary[pos / 4096] |= (uint64_t) 1 << ((pos / 64) % 64);
+    if(pos / 64 < central->hint){
+        central->hint = pos / 64;
+    }
+}
 
 /**
- * @brief Construtor da lista encadeada de memória virtual dos processos.
- * Cada memória virtual possui 1024 páginas.
+ * @brief Marca a posição como ocupada no mapa de bits e no resumo.
  * 
- * @return vm_list* 
+ * @param central Tabela ("frame" ou "block")
+ * @param pos Posição livre
  */
-vm_list* vm_list_create(){
-    vm_list* list = malloc(sizeof(vm_list));
-    struct vm_node* new_node = malloc(sizeof(struct vm_node));
-    new_node->data.pid = -1;
-    new_node->data.pages = (int*) calloc(NUM_PAGES, sizeof(int));
-    new_node->data.page_ptr = -1;
-    new_node->next = NULL;
-
-    list->head = new_node;
-    list->tail = list->head;
-    list->size = 0;
-
-    return list;
+void page_central_take(page_central* central, int pos){
+    page_central_claim(central, pos);
+    __sync_fetch_and_sub(&central->free, 1);
 }
 
+void magazine_flush_all(page_central* central);
+int magazine_keep(page_central* central, int pos);
+
 /**
- * @brief Cria uma nova instância de memória virtual para um processo, inicializada com valores padrão, que mostram que 
- * ainda não houve nenhuma tentativa de alocamento.
+ * @brief Marca como ocupada a posição livre de menor índice da tabela, sem ocupante. Quando o mapa de bits está vazio mas "free"
+ * indica posições livres, elas estão nos magazines, que são devolvidos antes de uma nova busca.
  * 
- * @param list A lista encadeada de memórias virtuais utilizadas para gerenciar o alocamento de páginas pelos processos
- * @param pid Indentificador do processo que alocará a nova instânica de memória virtual.
+ * @param central Tabela ("frame" ou "block")
+ * @return int A posição marcada, ou -1 caso a tabela esteja cheia.
  */
-void vm_list_insert_pid(vm_list* list, pid_t pid){
-    virtual_memory mem;
-    mem.pid = pid;
-    mem.pages = (int*) calloc(NUM_PAGES, sizeof(int));
-    mem.page_ptr = -1;
-
-    struct vm_node* node = malloc(sizeof(struct vm_node));
-    node->data = mem;
-    list->tail->next = node;
-    list->tail = node;
-    list->size++;
+int page_central_grab(page_central* central){
+    int pos = page_central_find_free(central);
+    if(pos == -1 && central->free > 0){
+        magazine_flush_all(central);
+        pos = page_central_find_free(central);
+    }
+    if(pos != -1){
+        page_central_take(central, pos);
+    }
+    return pos;
 }
 
 /**
- * @brief Percorre a lista encadeada de memórias virtuais buscando aquela que corresponde ao processo que deseja alocar
- * mais páginas de memória. Ao encontrar essa memória virtual, incrementa o ponteiro da última página solicitada para alocação
- * e converte esse ponteiro para um índice de memória virtual, com base nos endereços pré-estabelecidos (0x0000600000, ...)
+ * @brief Reserva a posição livre de menor índice da tabela para a página informada (ver "page_central_grab").
  * 
- * @param list Parâmetro global de gerenciamento de memória virtual "manager"
- * @param pid Identificador do processo ao qual será aumentada a quantidade de páginas na memória virtual
- * @return void* 
+ * @param central Tabela ("frame" ou "block")
+ * @param new_page Página que ocupará a posição
+ * @return int A posição reservada, ou -1 caso a tabela esteja cheia.
  */
-void* vm_list_increase_pages(vm_list* list, pid_t pid){
-    struct vm_node* curr = list->head;
-
-    while(curr != NULL && curr->data.pid != pid){
-        curr = curr->next;
+int page_central_alloc(page_central* central, page new_page){
+    int pos = page_central_grab(central);
+    if(pos != -1){
+        place_page(central, pos, new_page);
     }
-    curr->data.page_ptr++;
-    curr->data.pages[curr->data.page_ptr] = 1;
-    return INDEX_TO_VIRTUAL_ADDR(curr->data.page_ptr);
+    return pos;
 }
 
 /**
- * @brief Essa função busca a instância de memória virtual associada ao processo requisitante, na estrutura de gerenciamento "manager".
- * Caso o processo exista e possua uma memória virtual, ela é retornada. Caso contŕario, a cabeça da lista encadeada é retornada.
+ * @brief Libera uma posição da tabela, desalocando a página que a ocupava e guardando-a no magazine da thread atual (ver
+ * "magazine_keep") ou marcando-a como livre no mapa de bits. Deve ser chamada com o lock da tabela adquirido: ao contrário da
+ * retirada de um quadro do magazine, a liberação sempre altera estado protegido por ele ("frame.page_t" em "clean_page" e, nos
+ * chamadores, a política e o anel do processo).
  * 
- * @param list Parâmetro global de gerenciamento de memória virtual "manager"
- * @param pid Identificador do processo que se quer obter a memória virtual.
- * @return virtual_memory 
+ * @param central Tabela ("frame" ou "block")
+ * @param pos Posição a ser liberada
  */
-virtual_memory vm_list_get(vm_list* list, pid_t pid){
-    struct vm_node* curr = list->head;
-
-    while(curr != NULL && curr->data.pid != pid){
-        curr = curr->next;
+void page_central_release(page_central* central, int pos){
+    clean_page(central, pos);
+    if(!magazine_keep(central, pos)){
+        page_central_unclaim(central, pos);
     }
-
-    return curr == NULL ? list->head->data : curr->data;
+    __sync_fetch_and_add(&central->free, 1);
 }
 
+//-------------------------- REPLACEMENT POLICY ------------------------------------------------------------------
 
+/**
+ * @brief Interface das políticas de substituição de páginas. Todos os ganchos são chamados com "frame_lock" adquirido;
+ * ganchos NULL são ignorados.
+ * @param name Nome utilizado para selecionar a política na inicialização do "bin/mmu" (ex: policy=arc).
+ * @param init Inicializa o estado da política para "nframes" quadros.
+ * @param on_fault Uma página acabou de ser trazida para o quadro "pos".
+ * @param on_reference Foi observado um acesso à página do quadro "pos" (falha de página sobre página presente, ou bit de referência
+ * encontrado ligado durante a busca por uma vítima).
+ * @param pick_victim Indica o próximo quadro candidato a vítima, ou -1. O candidato só é removido se seu bit de referência estiver
+ * desligado e o lock de seu processo puder ser adquirido; caso contrário a política é consultada novamente.
+ * @param on_free O quadro "pos" será liberado, por substituição ("evicted" = 1) ou pela destruição do processo ("evicted" = 0).
+ * 
+ */
+typedef struct{
+    const char* name;
+    void (*init)(int nframes);
+    void (*on_fault)(int pos);
+    void (*on_reference)(int pos);
+    int (*pick_victim)(void);
+    void (*on_free)(int pos, int evicted);
+} replacement_policy;
 
 /**
- * @brief Verifica se a memória virtual relativa ao processo informado, possui o endereço recebido por parâmetro solicitado 
- * para alocação de página.
+ * @brief Fila duplamente encadeada de quadros, utilizada pelas políticas baseadas em listas (o início é a posição menos recente).
+ * Os encadeamentos ficam nos vetores "fq_prev" e "fq_next", indexados pelo quadro.
+ * @param head Primeiro quadro da fila, ou -1.
+ * @param tail Último quadro da fila, ou -1.
+ * @param size Quantidade de quadros na fila.
  * 
- * @param list Parâmetro global de gerenciamento de memória virtual "manager"
- * @param pid Identificador do processo que se quer verificar a alocação do endereço
- * @param vaddr Endereço a ser convertido em índice do vetor de páginas alocadas, para a verificação proposta pela função.
- * @return int 1 - Quando a página já foi solicitada para alocação. 0 - Caso contrário.
  */
-int vm_list_check_extended_page(vm_list* list, pid_t pid, void* vaddr){
-    struct vm_node* curr = list->head;
+typedef struct{
+    int head;
+    int tail;
+    int size;
+} frame_queue;
 
-    while(curr != NULL && curr->data.pid != pid){
-        curr = curr->next;
-    }
-    int alloc = VIRTUAL_ADDR_TO_INDEX(vaddr);
-    int alloced = curr->data.pages[alloc] & 0x03;
-    if(alloced){
-        // curr->data.pages[alloc] |= 0x02;
-        return 1;
-    }
-    return 0;
-}
+#define POLICY_QUEUES 2
 
 /**
- * @brief Recebe uma página de mêmoria e salva seus dados no gerenciador "manager". Salvo a permissão de page nos bits 3 e 4 do inteiro respectivo
- * aquela pagina
+ * @brief Estado compartilhado pelas políticas: as filas, os encadeamentos e a fila de cada quadro (-1 quando em nenhuma),
+ * indicadores por quadro, o ponteiro do relógio do CLOCK-Pro e o alvo adaptativo (p do ARC, alvo de páginas frias do CLOCK-Pro).
  * 
- * @param list - Parâmetro global de gerenciamento de memória virtual "manager" 
- * @param to_save - Pagina que se deseja salvar os dados na mêmoria
  */
-void vm_list_save_page(vm_list* list, page to_save){
-    struct vm_node* curr = list->head;
+frame_queue policy_queue[POLICY_QUEUES];
+int* fq_prev;
+int* fq_next;
+int* fq_queue;
+unsigned char* policy_flags;
+int policy_hand;
+int policy_target;
+int policy_hot;
 
-    while(curr != NULL && curr->data.pid != to_save.pid){
-        curr = curr->next;
-    }
-
-    int idx = VIRTUAL_ADDR_TO_INDEX(to_save.vaddr);
-    short permission = to_save.options.permission << 2;
-    curr->data.pages[idx] |= permission;
-    curr->data.pages[idx] &= 0xFD;
+#define POLICY_HOT 1
+#define POLICY_TEST 2
+#define POLICY_REF 4
 
-}
+/**
+ * @brief Listas fantasma (páginas removidas recentemente), utilizadas por 2Q, ARC e CLOCK-Pro. Cada remoção registrada recebe
+ * um número de sequência da lista; a página ainda pertence à lista enquanto menos de "ghost_capacity" remoções tiverem ocorrido
+ * depois dela, de forma que nenhuma estrutura precisa ser percorrida nem liberada.
+ * 
+ */
+unsigned int ghost_clock[3];
+unsigned int ghost_capacity[3];
 
 /**
- * @brief Remove a instância de memória virtual associada ao processo da lista encadeada.
+ * @brief Insere o quadro no final (posição mais recente) da fila informada.
  * 
- * @param list Parâmetro global de gerenciamento de memória virtual "manager"
- * @param pid Identificador do processo que será removido da lista
+ * @param q Índice da fila
+ * @param pos Quadro
  */
-void vm_list_remove_pid(vm_list* list, pid_t pid){
-    
-    if(list->size == 0){
-        return;
+void fq_push(int q, int pos){
+    frame_queue* queue = &policy_queue[q];
+    fq_prev[pos] = queue->tail;
+    fq_next[pos] = -1;
+    if(queue->tail != -1){
+        fq_next[queue->tail] = pos;
     }
-
-    struct vm_node* prev = list->head;
-    struct vm_node* curr = list->head->next;
-
-    while(curr != NULL && curr->data.pid != pid){
-        prev = curr;
-        curr = curr->next;
+    else{
+        queue->head = pos;
     }
-
-    struct vm_node* removeable = curr;
-    prev->next = curr->next;
-    list->size--;
-    free(removeable);
-    
+    queue->tail = pos;
+    queue->size++;
+    fq_queue[pos] = q;
 }
 
-//------------------------------------ SENCOND CHANCE ALGORITHM --------------------------------------------------------
 /**
- * @brief Procura na tabela de paginas presentes na mémoria principal por algum frame que possui o bit de referência como 0 para ser a proxima vitima
- * do do paginador e ser retirado da memoria. A cada pagina que possui um bit 1 é dada uma segunda chance e seu bit é colocado como 0
+ * @brief Retira o quadro da fila em que ele se encontra, se houver.
  * 
- * @return int - Posicao relativa da pagína de mêmoria que deverá ser retirada da mêmoria.
+ * @param pos Quadro
  */
-int second_chance(){
-    while(1){
-        if(sc_ptr == frame.size){
-            sc_ptr = 0;
-        }
-
-        if(frame.page_t[sc_ptr].options.reference_bit){
-            mmu_chprot(frame.page_t[sc_ptr].pid,frame.page_t[sc_ptr].vaddr,PROT_NONE);
-            frame.page_t[sc_ptr].options.permission = PROT_NONE;
-            frame.page_t[sc_ptr].options.reference_bit = 0;
-            sc_ptr++;
-        }
-        else{
-            sc_ptr++;
-            return sc_ptr - 1;
-        }
+void fq_remove(int pos){
+    if(fq_queue[pos] == -1){
+        return;
     }
-};
-/**
- * @brief Recebe a posição relativa a pagina que deve ser retirada da mêmoria e a nova pagína que deve ser escrita na mèmoria principal, caso neste
- * processo todas as páginas sejam "novas" na mêmoria, realizamos a troca de permissão destas para PROT_NONE. Em seguida retiramos a pagina desejada 
- * da mêmoria e caso ela não possua permissão de escrita, salvamos ela através de vm_list_save_page no "manager" e em seguida inicializamos a nova 
- * página no espaço da mêmoria principal
- * 
- * @param remove_pos  - Posição relativa na mêmoria ao frame que será retirado
- * @param new_page - Pagina que irá ocupar o espaço de mêmoria da pagina removida
- * @param new_page_origin - Se 1 ela foi originada do disco, caso 0 sua origem é do "manager".
- */
-void realloc_pages(int remove_pos,page new_page,int new_page_origin, int block_pos){
-    
-    page removed_page = frame.page_t[remove_pos]; 
-
-    mmu_nonresident(removed_page.pid,removed_page.vaddr);
-    removed_page.options.permission = PROT_READ;
-
-    if(removed_page.options.write_op == 0){
-        vm_list_save_page(manager,removed_page);
+    frame_queue* queue = &policy_queue[fq_queue[pos]];
+    if(fq_prev[pos] != -1){
+        fq_next[fq_prev[pos]] = fq_next[pos];
     }
     else{
-        block.page_t[remove_pos] = removed_page;
-        mmu_disk_write(remove_pos,remove_pos);
+        queue->head = fq_next[pos];
     }
-
-    frame.page_t[remove_pos] = new_page;
-    if(new_page_origin == 1){
-        clean_page(&block,block_pos);
-        mmu_disk_read(block_pos,remove_pos);
-        mmu_resident(new_page.pid,new_page.vaddr,remove_pos,PROT_READ);   
+    if(fq_next[pos] != -1){
+        fq_prev[fq_next[pos]] = fq_prev[pos];
     }
     else{
-        mmu_zero_fill(remove_pos);
-        mmu_resident(new_page.pid,new_page.vaddr,remove_pos,new_page.options.permission);
+        queue->tail = fq_prev[pos];
     }
+    queue->size--;
+    fq_queue[pos] = -1;
 }
 
-
-//-------------------------- PAGER CORE --------------------------------------------------------------------------------
-
 /**
- * @brief Define o tamanho da tabela de páginas na memória (frame) e no disco (block), aloca a quantidade de páginas relativas
- * a esse tamanho para ambas e as inicializa com valores padrão, retornando ao fim o gerenciador de alicação de páginas.
+ * @brief Retorna o primeiro quadro da fila como candidato, movendo-o para o final. Dessa forma, um candidato recusado
+ * (processo ocupado ou página referenciada) não é oferecido novamente antes dos demais.
  * 
- * @param nframes Número total de quadros em memória principal
- * @param nblocks Número total de quadros em memória secundária
+ * @param q Índice da fila
+ * @return int O quadro candidato, ou -1 caso a fila esteja vazia.
  */
-void pager_init(int nframes, int nblocks){
-    frame.size = frame.free = nframes;
-    block.size = block.free = nblocks;
-
-    frame.page_t = (page*) malloc(sizeof(page) * nframes);
-    block.page_t = (page*) malloc(sizeof(page) * nblocks);
-    sc_ptr = 0;
-
-
-    init_page_central(&frame);
-    init_page_central(&block);
-
-    manager = vm_list_create();
-    pthread_mutex_init(&lock,NULL);
+int fq_rotate(int q){
+    int pos = policy_queue[q].head;
+    if(pos != -1){
+        fq_remove(pos);
+        fq_push(q, pos);
+    }
+    return pos;
 }
 
 /**
- * @brief Essa função cria um novo paginador de memória virtual para o processo informado.
+ * @brief Registra uma página removida da memória principal na lista fantasma informada.
  * 
- * @param pid Identificador do processo que se quer criar um paginador.
+ * @param entry Entrada da tabela de páginas da página removida
+ * @param list Lista fantasma (1 ou 2)
  */
-void pager_create(pid_t pid){
-    pthread_mutex_trylock(&lock);
-    vm_list_insert_pid(manager, pid);
-    pthread_mutex_unlock(&lock);
+void ghost_record(page_entry* entry, int list){
+    entry->ghost = list;
+    entry->ghost_seq = ++ghost_clock[list];
 }
 
 /**
- * @brief Verifica se a memória secundária está disponível, de forma que se não estiver, não ocorre a extensão de páginas da 
- * memória virtual do processo e é retornado nulo.
- * Vale lembrar que, para cada página alocada na memória principal pelo processo, também é definida uma página na memória secundária 
- * para transferência futura, se necessário. Dessa forma, antes do aumento no número de páginas, a quantidade de endereços libres da 
- * memória secundária "bloc" é decrementada.
+ * @brief Verifica se a página pertence a alguma lista fantasma, retirando-a dela.
  * 
- * @param pid Identificador do processo que alocará mais uma página na memória virtual
- * @return void* Endereço virtual convertido com base na alocação da página.
+ * @param entry Entrada da tabela de páginas
+ * @return int A lista fantasma da página (1 ou 2), ou 0.
  */
-void* pager_extend(pid_t pid){
-    pthread_mutex_trylock(&lock);
-    if(block.free == 0){
-        pthread_mutex_unlock(&lock);
-        return NULL;
+int ghost_lookup(page_entry* entry){
+    int list = entry->ghost;
+    entry->ghost = 0;
+    if(list != 0 && ghost_clock[list] - entry->ghost_seq < ghost_capacity[list]){
+        return list;
     }
-
-    block.free--;
-    void* addr = vm_list_increase_pages(manager,pid);
-    pthread_mutex_unlock(&lock);
-    return addr;
+    return 0;
 }
 
 /**
- * @brief Função para tratamento de falhas de página. É verificado se o endereço virtual que se quer acessar, está presente
- * na memória princial "in_frame" ou na secundária "in_block", ou se já houve ao menos a solicitação de alocação desse endereço
- * "exist".  
- * 
- * Quando o endereço não está em nenhuma das memórias, quer dizer que aquele é o primeiro acesso a ele. Dessa forma, é verificado
- * se ele já foi previamente alocado pelo gerenciador de memória virtual "manager", retornando sem realizar nenhuma ação em caso negativo.  
- * 
- * Dessa forma, se houver espaço o suficiente na memória principal, o endereço é alocado a ela. Caso contrário, é executado o algoritmo 
- * de segunda chance, buscando um elemento da memória principal a ser movido para a secundária e, dessa forma, permitir ao programa a
- * utilização do atual endereço.
- * 
- * Quando o endereço acessado já está na memória principal, as permissões dele são alteradas gradualmente a cada acesso. Seguindo a ordem
- * PROT_NONE -> PROT_READ -> PROT_READ | PROT_WRITE
+ * @brief Tamanho aproximado de uma lista fantasma.
  * 
- * Quando o endereço acessado já está na memória secundária, executamos o algoritmo de segunda chance, buscando o elemento a ser removido. Em seguida
- * transferimos a pagina do disco para o espaço de frame definido, e a pagina removida recebe seu devido tratamento.
+ * @param list Lista fantasma (1 ou 2)
+ * @return int Quantidade de páginas na lista
+ */
+int ghost_size(int list){
+    return ghost_clock[list] < ghost_capacity[list] ? (int) ghost_clock[list] : (int) ghost_capacity[list];
+}
+
+/**
+ * @brief Inicializa o estado compartilhado pelas políticas.
  * 
- * @param pid Identificadro do processo ao qual será tratada a falha de página ao acessar o endereço, se necessário.
- * @param addr Endereço relativo ao processo que se quer acessar.
+ * @param nframes Quantidade de quadros da memória principal
  */
-void pager_fault(pid_t pid, void *addr){
-    pthread_mutex_trylock(&lock);
-    int frame_pos,block_pos;
-    int remove_pos;
-    short page_permission;
-    page new_page;
-    
-    addr = NORM_VIRTUAL_ADDR(addr);
-    int in_frame = check_page_allocation(&frame,pid,addr,&frame_pos);
-    int in_block = check_page_allocation(&block,pid,addr,&block_pos);
-    int exist = vm_list_check_extended_page(manager,pid,addr);
-    // printf("in_frame; %d, in_block: %d, exist: %d \n",in_frame,in_block,exist);
-
-
-    if(!in_frame && !in_block){
-        if(!exist){
-            pthread_mutex_unlock(&lock);
-            return;
-        }
-
-        new_page.pid = pid;
-        new_page.vaddr = addr;
-        new_page.options.write_op = 0;
-        new_page.options.permission = PROT_READ;
-        
-        if(frame.free > 0){
-            int alloc_pos = frame.size - frame.free;
-            frame.page_t[alloc_pos] = new_page;
-            frame.free--;
-            mmu_zero_fill(alloc_pos);
-            mmu_resident(pid,addr,alloc_pos,PROT_READ);
-        }
-        else{
-            remove_pos = second_chance();
-            realloc_pages(remove_pos,new_page,0,NULL);
-            
-        }
+void policy_init_common(int nframes){
+    for(int q = 0; q < POLICY_QUEUES; q++){
+        policy_queue[q].head = policy_queue[q].tail = -1;
+        policy_queue[q].size = 0;
     }
-    else if(in_frame){
-        if(frame.page_t[frame_pos].options.permission == PROT_NONE){
-            frame.page_t[frame_pos].options.permission = PROT_READ;
-        }
-        else if(frame.page_t[frame_pos].options.permission == PROT_READ){
-            frame.page_t[frame_pos].options.write_op = 1;
-            frame.page_t[frame_pos].options.permission = PROT_WRITE | PROT_READ;
-        }
-        new_page.options.reference_bit = 1;
-        mmu_chprot(pid,addr,frame.page_t[frame_pos].options.permission);
+    fq_prev = (int*) malloc(sizeof(int) * nframes);
+    fq_next = (int*) malloc(sizeof(int) * nframes);
+    fq_queue = (int*) malloc(sizeof(int) * nframes);
+    policy_flags = (unsigned char*) calloc(nframes, sizeof(unsigned char));
+    for(int i = 0; i < nframes; i++){
+        fq_queue[i] = -1;
     }
+    policy_hand = 0;
+    policy_hot = 0;
+    for(int list = 0; list < 3; list++){
+        ghost_clock[list] = 0;
+        ghost_capacity[list] = nframes;
+    }
+}
 
-    else if(in_block){
-        remove_pos = second_chance();
-        new_page = block.page_t[block_pos];
-        new_page.options.reference_bit = 1;
-        realloc_pages(remove_pos,new_page,1,block_pos);
+//---- CLOCK: algoritmo de segunda chance sobre os quadros, na ordem das posições.
 
+int clock_pick_victim(void){
+    if(sc_ptr >= frame.size){
+        sc_ptr = 0;
     }
-    else{
-        printf("F*deu geral, tem pagina na memoria e no disco AO MESMO TEMPO \n");  
-        exit(EXIT_FAILURE);
-    }
-    pthread_mutex_unlock(&lock);
+    return sc_ptr++;
 }
 
-/**
- * @brief Essa função é utilizada para imprimir os dados armazenados na memória como bytes (hexadecimais), a partir de um
- * endereço inicial até o tamanho total informado, sem verificação de permissão do processo em relação à região lida.
- * 
- * Para isso, verifica se o endereço que se quer acessar está dentro do intervalo de memória disponível, retornando "-1" caso negativo.
- * Após isso, obtém a instância de memória virtual relativa àquele processo, verificando se o endereço solicitado já 
- * foi alocado.
- * 
- * @param pid Identificador do processo que contem o primeiro endereço, cujo conteúdo será exibido
- * @param addr Endereço da memória virtual contendo o início da região, cujos conteúdos serão exibidos
- * @param len Tamanho da região total que terá os conteúdos exibidos.
- * @return int -1 - Quando não foi possível realizar a leitura. 0 - Quando foi possível realizar a leitura.
- */
-int pager_syslog(pid_t pid, void *addr, size_t len){
-    pthread_mutex_trylock(&lock);
-    int addr_under_base = ((long) addr < UVM_BASEADDR);
-    int addr_above_max = ((long) addr > UVM_MAXADDR);
-    if(addr_under_base || addr_above_max){
-        pthread_mutex_unlock(&lock);
-        return -1;
+//---- LRU: aproximação de LRU. Cada acesso observado move o quadro para o final da fila, e as vítimas são buscadas a partir do início.
+
+void lru_init(int nframes){
+    policy_init_common(nframes);
+}
+
+void lru_on_fault(int pos){
+    fq_push(0, pos);
+}
+
+void lru_on_reference(int pos){
+    fq_remove(pos);
+    fq_push(0, pos);
+}
+
+int lru_pick_victim(void){
+    return fq_rotate(0);
+}
+
+void lru_on_free(int pos, int evicted){
+    fq_remove(pos);
+}
+
+//---- 2Q: páginas novas entram na fila FIFO A1in (fila 0); ao voltar enquanto estão na lista fantasma A1out (lista 1), entram
+//---- na fila LRU Am (fila 1). As vítimas saem de A1in enquanto ela ocupar mais de 1/4 dos quadros.
+
+void twoq_init(int nframes){
+    policy_init_common(nframes);
+    policy_target = nframes / 4 > 0 ? nframes / 4 : 1;
+    ghost_capacity[1] = nframes / 2 > 0 ? nframes / 2 : 1;
+}
+
+void twoq_on_fault(int pos){
+    fq_push(ghost_lookup(frame.page_t[pos].entry) == 1 ? 1 : 0, pos);
+}
+
+void twoq_on_reference(int pos){
+    if(fq_queue[pos] == 1){
+        fq_remove(pos);
+        fq_push(1, pos);
     }
-    int index = VIRTUAL_ADDR_TO_INDEX(addr);
-    virtual_memory mem = vm_list_get(manager, pid);
-    if(index > mem.page_ptr){
-        pthread_mutex_unlock(&lock);
-        return -1;
+}
+
+int twoq_pick_victim(void){
+    if(policy_queue[0].size > policy_target || policy_queue[1].size == 0){
+        return fq_rotate(0);
     }
+    return fq_rotate(1);
+}
 
-    void* vaddr = INDEX_TO_VIRTUAL_ADDR(index);
-    const char* buf = (char*) malloc(sizeof(char) * len);
-    buf = pmem + (index * PAGE_SIZE) + (addr - vaddr);
-    for(int i = 0; i < len; i++){
-        printf("%02x", (unsigned)buf[i]);
+void twoq_on_free(int pos, int evicted){
+    if(evicted && fq_queue[pos] == 0){
+        ghost_record(frame.page_t[pos].entry, 1);
     }
-    printf("\n");
-    pthread_mutex_unlock(&lock);
-    return 0;
+    fq_remove(pos);
 }
 
-/**
- * @brief Destrói todas as páginas relativas a um processo, tanto na tabela de páginas da memória principal
- * quanto da secundária, removendo a memória virtual associada a ele ao final.
- * 
- * @param pid Identificador do processo que foi finalizado, tendo a memória desalocada.
- */
-void pager_destroy(pid_t pid){
+//---- ARC: T1 (fila 0) guarda páginas acessadas uma vez e T2 (fila 1) páginas acessadas novamente; B1 e B2 (listas 1 e 2) são
+//---- suas listas fantasma. Um retorno pela B1 aumenta o alvo "policy_target" de T1, um retorno pela B2 o diminui.
 
-    pthread_mutex_trylock(&lock);
-    for(int i = 0; i < frame.size; i++){
-        if(frame.page_t[i].pid == pid){
-            frame.page_t[i].pid = -1;
-            frame.page_t[i].vaddr = NO_ALLOC;
-            frame.page_t[i].options.permission = 0;
-            frame.page_t[i].options.write_op = 0;
-            frame.free++;
-        }
-    }
+void arc_init(int nframes){
+    policy_init_common(nframes);
+    policy_target = 0;
+}
 
-    for(int i = 0; i < block.size; i++){
-        if(block.page_t[i].pid == pid){
-            block.page_t[i].pid = -1;
-            block.page_t[i].vaddr = NO_ALLOC;
-            block.page_t[i].options.permission = 0;
-            block.page_t[i].options.write_op = 0;
-            block.free++;
-        }
+void arc_on_fault(int pos){
+    int list = ghost_lookup(frame.page_t[pos].entry);
+    if(list == 1){
+        int delta = ghost_size(2) > ghost_size(1) ? ghost_size(2) / ghost_size(1) : 1;
+        policy_target = policy_target + delta < frame.size ? policy_target + delta : frame.size;
     }
+    else if(list == 2){
+        int delta = ghost_size(1) > ghost_size(2) ? ghost_size(1) / ghost_size(2) : 1;
+        policy_target = policy_target - delta > 0 ? policy_target - delta : 0;
+    }
+    fq_push(list != 0 ? 1 : 0, pos);
+}
+
+void arc_on_reference(int pos){
+    fq_remove(pos);
+    fq_push(1, pos);
+}
+
+int arc_pick_victim(void){
+    if(policy_queue[0].size > 0 && (policy_queue[0].size > policy_target || policy_queue[1].size == 0)){
+        return fq_rotate(0);
+    }
+    return fq_rotate(1);
+}
+
+void arc_on_free(int pos, int evicted){
+    if(evicted){
+        ghost_record(frame.page_t[pos].entry, fq_queue[pos] == 0 ? 1 : 2);
+    }
+    fq_remove(pos);
+}
+
+//---- CLOCK-Pro: páginas quentes e frias em um único relógio. Páginas novas entram frias e em período de teste; uma página fria
+//---- acessada durante o teste torna-se quente. O ponteiro rebaixa páginas quentes não acessadas enquanto houver mais quentes que
+//---- "frame.size - policy_target", e só oferece páginas frias como vítimas. Páginas frias removidas durante o teste vão para a
+//---- lista fantasma 1; voltar por ela aumenta o alvo de páginas frias.
+
+void clockpro_init(int nframes){
+    policy_init_common(nframes);
+    policy_target = nframes / 2 > 0 ? nframes / 2 : 1;
+}
+
+void clockpro_on_fault(int pos){
+    if(ghost_lookup(frame.page_t[pos].entry) == 1){
+        if(policy_target < frame.size - 1){
+            policy_target++;
+        }
+        policy_flags[pos] = POLICY_HOT;
+        policy_hot++;
+    }
+    else{
+        policy_flags[pos] = POLICY_TEST;
+    }
+}
+
+void clockpro_on_reference(int pos){
+    policy_flags[pos] |= POLICY_REF;
+    if(policy_flags[pos] & POLICY_HOT){
+        return;
+    }
+    if(policy_flags[pos] & POLICY_TEST){
+        policy_flags[pos] = POLICY_HOT;
+        policy_hot++;
+    }
+    else{
+        policy_flags[pos] |= POLICY_TEST;
+    }
+}
+
+int clockpro_pick_victim(void){
+    for(int step = 0; step < 2 * frame.size; step++){
+        if(policy_hand >= frame.size){
+            policy_hand = 0;
+        }
+        int pos = policy_hand++;
+        if(frame.page_t[pos].entry == NULL || !(policy_flags[pos] & POLICY_HOT)){
+            return pos;
+        }
+        if(policy_hot > frame.size - policy_target){
+            if(policy_flags[pos] & POLICY_REF){
+                policy_flags[pos] &= ~POLICY_REF;
+            }
+            else{
+                policy_flags[pos] = 0;
+                policy_hot--;
+            }
+        }
+    }
+    return policy_hand - 1;
+}
+
+void clockpro_on_free(int pos, int evicted){
+    if(policy_flags[pos] & POLICY_HOT){
+        policy_hot--;
+    }
+    else if(evicted && (policy_flags[pos] & POLICY_TEST)){
+        ghost_record(frame.page_t[pos].entry, 1);
+    }
+    else if(evicted && policy_target > 1){
+        policy_target--;
+    }
+    policy_flags[pos] = 0;
+}
+
+//---- NRU: relógio aprimorado. Em uma volta a partir do ponteiro, oferece o primeiro quadro não referenciado e limpo (cuja retirada
+//---- não exige escrita no disco); sem nenhum, se comporta como o relógio. Com a escrita em segundo plano ativa, os quadros não
+//---- referenciados e sujos encontrados no caminho são enfileirados para serem limpos antes de se tornarem vítimas.
+
+/**
+ * @brief Fila circular de quadros sujos a serem escritos no disco pelo daemon de escrita (opção writeback=1), protegida por
+ * "frame_lock". "wb_queued" evita que um quadro seja enfileirado duas vezes.
+ * 
+ */
+int writeback_enabled;
+int* wb_ring;
+unsigned char* wb_queued;
+int wb_head;
+int wb_count;
+pthread_cond_t writeback_cond;
+/**
+ * @brief Chamadas a "writeback_wakeup" que encontraram quadros enfileirados, protegidas por "frame_lock". O daemon de escrita as
+ * utiliza para aguardar o fim de alguma falha quando todos os donos dos quadros enfileirados estão ocupados, sem perder um aviso
+ * feito durante a volta.
+ * 
+ */
+unsigned long wb_wakeups;
+
+/**
+ * @brief Enfileira um quadro para escrita em segundo plano, acordando o daemon de escrita.
+ * 
+ * @param pos Quadro
+ */
+void writeback_enqueue(int pos){
+    if(wb_queued[pos] || wb_count == frame.size){
+        return;
+    }
+    wb_queued[pos] = 1;
+    wb_ring[(wb_head + wb_count) % frame.size] = pos;
+    wb_count++;
+    pthread_cond_signal(&writeback_cond);
+}
+
+/**
+ * @brief Limite de quadros examinados pelo NRU antes de recorrer ao relógio, para que o custo de uma falta não cresça com a
+ * quantidade de quadros em configurações grandes.
+ * 
+ */
+#define NRU_SCAN_LIMIT 64
+
+int nru_pick_victim(void){
+    for(int step = 0; step < frame.size && step < NRU_SCAN_LIMIT; step++){
+        if(sc_ptr >= frame.size){
+            sc_ptr = 0;
+        }
+        int pos = sc_ptr++;
+        page_entry* entry = frame.page_t[pos].entry;
+        if(entry == NULL || entry->options.reference_bit){
+            continue;
+        }
+        if(!entry->options.dirty){
+            return pos;
+        }
+        if(writeback_enabled){
+            writeback_enqueue(pos);
+        }
+    }
+    return clock_pick_victim();
+}
+
+/**
+ * @brief Políticas disponíveis. A primeira é a padrão.
+ * 
+ */
+replacement_policy policies[] = {
+    {"clock", NULL, NULL, NULL, clock_pick_victim, NULL},
+    {"lru", lru_init, lru_on_fault, lru_on_reference, lru_pick_victim, lru_on_free},
+    {"clockpro", clockpro_init, clockpro_on_fault, clockpro_on_reference, clockpro_pick_victim, clockpro_on_free},
+    {"2q", twoq_init, twoq_on_fault, twoq_on_reference, twoq_pick_victim, twoq_on_free},
+    {"arc", arc_init, arc_on_fault, arc_on_reference, arc_pick_victim, arc_on_free},
+    {"nru", NULL, NULL, NULL, nru_pick_victim, NULL},
+};
+
+/**
+ * @brief Política de substituição em uso, escolhida por "pager_setopt" antes de "pager_init".
+ * 
+ */
+replacement_policy* policy = &policies[0];
+
+//-------------------------- PAGE TABLE --------------------------------------------------------------------------
+
+/**
+ * @brief Parâmetros da árvore radix que implementa a tabela de páginas de cada processo. Cada nível consome
+ * PT_BITS bits do índice da página, de forma que um nó possui PT_FANOUT posições. Os nós folha guardam PT_FANOUT
+ * entradas "page_entry" e só são criados quando alguma página do intervalo coberto por eles é solicitada.
+ * 
+ */
+#define PT_BITS 6
+#define PT_FANOUT (1 << PT_BITS)
+#define PT_MASK (PT_FANOUT - 1)
+
+/**
+ * @brief Nó interno da árvore radix, apontando para nós do nível inferior (ou para folhas de "page_entry").
+ * @param slots Filhos do nó, NULL quando nenhuma página do intervalo foi solicitada.
+ * 
+ */
+typedef struct{
+    void* slots[PT_FANOUT];
+} page_table_node;
+
+/**
+ * @brief Quantidade de níveis da árvore, suficiente para indexar todas as páginas entre UVM_BASEADDR e UVM_MAXADDR.
+ * 
+ */
+int pt_levels;
+
+/**
+ * @brief Cria um nó da árvore. Nós do nível 0 são folhas, com PT_FANOUT entradas inicializadas como não utilizadas.
+ * 
+ * @param level Nível do nó a ser criado
+ * @return void* O nó criado
+ */
+void* page_table_node_create(int level){
+    if(level > 0){
+        return calloc(1, sizeof(page_table_node));
+    }
+
+    page_entry* leaf = (page_entry*) malloc(sizeof(page_entry) * PT_FANOUT);
+    for(int i = 0; i < PT_FANOUT; i++){
+        leaf[i].state = PAGE_UNUSED;
+        leaf[i].options.write_op = 0;
+        leaf[i].options.dirty = 0;
+        leaf[i].options.prefetched = 0;
+        leaf[i].options.cow = 0;
+        leaf[i].options.zero = 0;
+        leaf[i].options.advice = UVM_ADV_NORMAL;
+        leaf[i].options.cold = 0;
+        leaf[i].options.pinned = 0;
+        leaf[i].options.permission = PROT_NONE;
+        leaf[i].options.reference_bit = 0;
+        leaf[i].frame = -1;
+        leaf[i].block = -1;
+        leaf[i].ghost = 0;
+        leaf[i].ghost_seq = 0;
+    }
+    return leaf;
+}
+
+/**
+ * @brief Percorre a árvore radix a partir da raiz até a entrada da página de índice "idx".
+ * 
+ * @param root Endereço da raiz da tabela de páginas do processo
+ * @param idx Índice da página (ver VIRTUAL_ADDR_TO_INDEX)
+ * @param create Se 1, cria os nós que faltam no caminho. Se 0, retorna NULL ao encontrar um nó inexistente.
+ * @return page_entry* A entrada da página, ou NULL caso ela não exista e "create" seja 0.
+ */
+page_entry* page_table_walk(void** root, long idx, int create){
+    if(idx < 0 || idx >= NUM_PAGES){
+        return NULL;
+    }
+
+    void** slot = root;
+    for(int level = pt_levels - 1; ; level--){
+        if(*slot == NULL){
+            if(!create){
+                return NULL;
+            }
+            *slot = page_table_node_create(level);
+        }
+        if(level == 0){
+            return &((page_entry*) *slot)[idx & PT_MASK];
+        }
+        slot = &((page_table_node*) *slot)->slots[(idx >> (level * PT_BITS)) & PT_MASK];
+    }
+}
+
+void zswap_drop(int block_pos);
+
+/**
+ * @brief Libera recursivamente os nós da árvore, devolvendo às tabelas "frame" e "block" as posições ocupadas pelas
+ * páginas encontradas nas folhas.
+ * 
+ * @param node Nó a ser liberado
+ * @param level Nível do nó
+ */
+void page_table_destroy(void* node, int level){
+    if(node == NULL){
+        return;
+    }
+
+    if(level > 0){
+        for(int i = 0; i < PT_FANOUT; i++){
+            page_table_destroy(((page_table_node*) node)->slots[i], level - 1);
+        }
+    }
+    else{
+        page_entry* leaf = (page_entry*) node;
+        for(int i = 0; i < PT_FANOUT; i++){
+            if(leaf[i].frame != -1){
+                if(policy->on_free != NULL){
+                    policy->on_free(leaf[i].frame, 0);
+                }
+                page_central_release(&frame, leaf[i].frame);
+            }
+            if(leaf[i].block != -1){
+                zswap_drop(leaf[i].block);
+                page_central_release(&block, leaf[i].block);
+            }
+        }
+    }
+    free(node);
+}
+
+//-------------------------- VIRTUAL MEMORY ---------------------------------------------------------------------
+
+/**
+ * @brief Orçamento de quadros inicial (e mínimo) de um processo, quando a opção pff está ativa.
+ * 
+ */
+#define PFF_MIN_BUDGET 4
+
+/**
+ * @brief Estrutura para identificar quais páginas um determinado processo solicitou a alocação para ele, sem necessariamente utilizá-las.
+ * Essa é uma estrutura intermediária, de forma que quando um processo faz a chamada de "pager_extend()", a "virtual_memory" armazena a solicitação
+ * de extensão daquele processo, evitando um "page_fault" em uma possível tentativa de acesso futura.
+ * Vale ressaltar que é *memória virtual*, então diversos processos podem compartilhar a mesma posição de página.
+ * @param pid Identificador do processo que detem essa memória virtual
+ * @param page_table Raiz da árvore radix com as entradas das páginas solicitadas pelo processo
+ * @param page_ptr Índice da última página que teve a alocação solicitada pelo processo
+ * @param lock Mutex do processo, que protege sua tabela de páginas e serializa as chamadas à MMU referentes a ele.
+ * @param holder Thread que detém "lock", válido apenas enquanto "held" for 1.
+ * @param held Indica se "lock" está adquirido por meio de "vm_acquire"/"vm_try_acquire".
+ * @param refs Quantidade de referências à estrutura (a tabela e cada thread que a adquiriu); ela é liberada ao chegar a 0.
+ * @param dead Indica que o processo foi destruído e não pode mais ser adquirido.
+ * @param resident Quantidade de quadros ocupados pelo processo (protegido por "frame_lock").
+ * @param resident_head Um dos quadros do anel de quadros do processo, ou -1 (protegido por "frame_lock").
+ * @param deferred Páginas do processo que ocuparam quadros retirados de um magazine sem "frame_lock" e que ainda não estão em
+ * "frame.page_t", no anel do processo e na política (ver "frame_defer"). Esvaziado, no mais tardar, por "vm_unlock".
+ * @param deferred_count Quantidade de páginas em "deferred".
+ * @param budget Quantidade de quadros que o processo pode ocupar antes de substituir suas próprias páginas (opção pff).
+ * @param last_fault Valor de "pff_clock" na última página trazida para a memória principal pelo processo.
+ * @param ra_window Quantidade de páginas lidas antecipadamente na próxima falha sequencial (opção readahead).
+ * @param ra_next Índice da página cuja falha será considerada sequencial, ou -1.
+ * @param pinned Quantidade de páginas fixadas por "pager_lock" (protegido por "frame_lock").
+ * @param pinned_zero Quantas das páginas fixadas estão mapeadas no quadro de zeros e não contam em "pinned_total" (protegido por
+ * "frame_lock").
+ * @param limits Limites de quadros, de páginas guardadas em disco e de páginas solicitadas, indexados pelas constantes UVM_LIMIT_*
+ * (0 quando não há limite).
+ * @param swapped Quantidade de páginas do processo guardadas em disco (no estado PAGE_IN_BLOCK).
+ * @param faults Quantidade de falhas de página tratadas.
+ * 
+ */
+typedef struct{
+    pid_t pid;
+    void* page_table;
+    int page_ptr;
+    pthread_mutex_t lock;
+    pthread_t holder;
+    int held;
+    int refs;
+    int dead;
+    int resident;
+    int resident_head;
+    page* deferred;
+    int deferred_count;
+    int budget;
+    unsigned long last_fault;
+    int ra_window;
+    long ra_next;
+    int pinned;
+    int pinned_zero;
+    unsigned long limits[UVM_LIMIT_COUNT];
+    unsigned long swapped;
+    unsigned long faults;
+} virtual_memory;
+
+/**
+ * @brief Tabela hash de memórias virtuais dos processos, indexada pelo PID com endereçamento aberto (sondagem linear).
+ * Inserção, busca e remoção têm custo constante, independente da quantidade de processos em execução.
+ * @param slots Vetor de ponteiros para as memórias virtuais, com tamanho potência de 2. Posições vazias são NULL.
+ * @param mask Tamanho do vetor menos 1, utilizado para calcular a posição inicial de um PID.
+ * @param size Quantidade de processos registrados
+ * 
+ */
+typedef struct{
+    virtual_memory** slots;
+    unsigned long mask;
+    int size;
+} vm_registry;
+
+/**
+ * @brief Capacidade inicial da tabela de memórias virtuais. A tabela dobra de tamanho sempre que a ocupação passa de 50%.
+ * 
+ */
+#define VM_REGISTRY_INITIAL_SLOTS 64
+
+/**
+ * @brief Variável única de gerenciamento das solicitações de alocação de página
+ * 
+ */
+vm_registry* manager;
+/**
+ * @brief Protege a estrutura de "manager". Buscas adquirem o lock para leitura; inserções e remoções, para escrita.
+ * 
+ */
+pthread_rwlock_t registry_lock;
+
+/**
+ * @brief Calcula a posição inicial de um PID na tabela (hash multiplicativo de Fibonacci).
+ * 
+ * @param list Parâmetro global de gerenciamento de memória virtual "manager"
+ * @param pid Identificador do processo
+ * @return unsigned long Posição inicial de sondagem
+ */
+unsigned long vm_registry_hash(vm_registry* list, pid_t pid){
+    return (((unsigned long) pid * 0x9E3779B97F4A7C15UL) >> 32) & list->mask;
+}
+
+/**
+ * @brief Construtor da tabela de memórias virtuais dos processos.
+ * As tabelas de páginas começam vazias e crescem conforme as páginas são solicitadas.
+ * 
+ * @return vm_registry* 
+ */
+vm_registry* vm_registry_create(){
+    vm_registry* list = malloc(sizeof(vm_registry));
+    list->slots = (virtual_memory**) calloc(VM_REGISTRY_INITIAL_SLOTS, sizeof(virtual_memory*));
+    list->mask = VM_REGISTRY_INITIAL_SLOTS - 1;
+    list->size = 0;
+
+    return list;
+}
+
+/**
+ * @brief Dobra a capacidade da tabela, reinserindo as memórias virtuais já registradas.
+ * 
+ * @param list Parâmetro global de gerenciamento de memória virtual "manager"
+ */
+void vm_registry_grow(vm_registry* list){
+    virtual_memory** old_slots = list->slots;
+    unsigned long old_size = list->mask + 1;
+
+    list->slots = (virtual_memory**) calloc(old_size * 2, sizeof(virtual_memory*));
+    list->mask = old_size * 2 - 1;
+    for(unsigned long i = 0; i < old_size; i++){
+        if(old_slots[i] == NULL){
+            continue;
+        }
+        unsigned long j = vm_registry_hash(list, old_slots[i]->pid);
+        while(list->slots[j] != NULL){
+            j = (j + 1) & list->mask;
+        }
+        list->slots[j] = old_slots[i];
+    }
+    free(old_slots);
+}
+
+/**
+ * @brief Cria uma nova instância de memória virtual para um processo, inicializada com valores padrão, que mostram que 
+ * ainda não houve nenhuma tentativa de alocamento, e a registra na tabela.
+ * 
+ * @param list A tabela de memórias virtuais utilizada para gerenciar o alocamento de páginas pelos processos
+ * @param pid Indentificador do processo que alocará a nova instânica de memória virtual.
+ */
+void vm_registry_insert_pid(vm_registry* list, pid_t pid){
+    if(2 * (unsigned long) (list->size + 1) > list->mask + 1){
+        vm_registry_grow(list);
+    }
+
+    virtual_memory* mem = malloc(sizeof(virtual_memory));
+    mem->pid = pid;
+    mem->page_table = NULL;
+    mem->page_ptr = -1;
+    pthread_mutex_init(&mem->lock, NULL);
+    mem->held = 0;
+    mem->refs = 1;
+    mem->dead = 0;
+    mem->resident = 0;
+    mem->resident_head = -1;
+    mem->deferred = NULL;
+    mem->deferred_count = 0;
+    mem->budget = PFF_MIN_BUDGET;
+    mem->last_fault = 0;
+    mem->ra_window = 1;
+    mem->ra_next = -1;
+    mem->pinned = 0;
+    mem->pinned_zero = 0;
+    memcpy(mem->limits, default_limits, sizeof(default_limits));
+    mem->swapped = 0;
+    mem->faults = 0;
+
+    unsigned long i = vm_registry_hash(list, pid);
+    while(list->slots[i] != NULL){
+        i = (i + 1) & list->mask;
+    }
+    list->slots[i] = mem;
+    list->size++;
+}
+
+/**
+ * @brief Essa função busca a instância de memória virtual associada ao processo requisitante, na estrutura de gerenciamento "manager".
+ * 
+ * @param list Parâmetro global de gerenciamento de memória virtual "manager"
+ * @param pid Identificador do processo que se quer obter a memória virtual.
+ * @return virtual_memory* A memória virtual do processo, ou NULL caso o processo não esteja registrado.
+ */
+virtual_memory* vm_registry_get(vm_registry* list, pid_t pid){
+    unsigned long i = vm_registry_hash(list, pid);
+
+    while(list->slots[i] != NULL){
+        if(list->slots[i]->pid == pid){
+            return list->slots[i];
+        }
+        i = (i + 1) & list->mask;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Incrementa o ponteiro da última página solicitada para alocação pelo processo, marca a entrada correspondente da tabela
+ * de páginas como solicitada e converte esse ponteiro para um endereço virtual, com base nos endereços pré-estabelecidos (0x0000600000, ...)
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @return void* Endereço da nova página, ou NULL caso o espaço de endereçamento do processo esteja esgotado.
+ */
+void* vm_increase_pages(virtual_memory* mem){
+    page_entry* entry = page_table_walk(&mem->page_table, mem->page_ptr + 1, 1);
+    if(entry == NULL){
+        return NULL;
+    }
+
+    mem->page_ptr++;
+    entry->state = PAGE_EXTENDED;
+    return INDEX_TO_VIRTUAL_ADDR(mem->page_ptr);
+}
+
+/**
+ * @brief Remove a instância de memória virtual associada ao processo da tabela. As posições seguintes do mesmo
+ * agrupamento são deslocadas para trás, de forma que nenhuma busca futura seja interrompida pela posição esvaziada.
+ * 
+ * @param list Parâmetro global de gerenciamento de memória virtual "manager"
+ * @param pid Identificador do processo que será removido da tabela
+ * @return virtual_memory* A memória virtual removida, ou NULL caso o processo não esteja registrado.
+ */
+virtual_memory* vm_registry_remove_pid(vm_registry* list, pid_t pid){
+    unsigned long hole = vm_registry_hash(list, pid);
+    while(list->slots[hole] != NULL && list->slots[hole]->pid != pid){
+        hole = (hole + 1) & list->mask;
+    }
+    if(list->slots[hole] == NULL){
+        return NULL;
+    }
+
+    virtual_memory* mem = list->slots[hole];
+    unsigned long i = (hole + 1) & list->mask;
+    while(list->slots[i] != NULL){
+        unsigned long home = vm_registry_hash(list, list->slots[i]->pid);
+        if(((i - home) & list->mask) >= ((i - hole) & list->mask)){
+            list->slots[hole] = list->slots[i];
+            hole = i;
+        }
+        i = (i + 1) & list->mask;
+    }
+    list->slots[hole] = NULL;
+    list->size--;
+    return mem;
+}
+
+/**
+ * @brief Libera uma referência à memória virtual, desalocando a estrutura quando não restar nenhuma.
+ * 
+ * @param mem Memória virtual
+ */
+void vm_put(virtual_memory* mem){
+    if(__sync_sub_and_fetch(&mem->refs, 1) == 0){
+        pthread_mutex_destroy(&mem->lock);
+        free(mem->deferred);
+        free(mem);
+    }
+}
+
+void cow_teardown(virtual_memory* mem);
+void frame_lock_process(virtual_memory* mem);
+
+/**
+ * @brief Devolve às tabelas "frame" e "block" todas as posições ocupadas pelas páginas do processo e libera sua tabela de páginas.
+ * Quadros e blocos compartilhados com outros processos apenas perdem uma referência (ver "cow_teardown").
+ * Deve ser chamada com o lock do processo adquirido.
+ * 
+ * @param mem Memória virtual
+ */
+void vm_teardown(virtual_memory* mem){
+    frame_lock_process(mem);
+    pthread_mutex_lock(&block_lock);
+    cow_teardown(mem);
+    page_table_destroy(mem->page_table, pt_levels - 1);
+    if(overcommit_mode != OVERCOMMIT_STRICT){
+        committed_pages -= mem->page_ptr + 1;
+    }
+    mem->resident = 0;
+    mem->resident_head = -1;
+    pinned_total -= mem->pinned - mem->pinned_zero;
+    mem->pinned = 0;
+    mem->pinned_zero = 0;
+    pthread_mutex_unlock(&block_lock);
+    pthread_mutex_unlock(&frame_lock);
+    mem->page_table = NULL;
+}
+
+/**
+ * @brief Busca a memória virtual do processo e adquire seu lock, aguardando caso outra thread o detenha.
+ * 
+ * @param pid Identificador do processo
+ * @return virtual_memory* A memória virtual adquirida, ou NULL caso o processo não exista ou já tenha sido destruído.
+ */
+virtual_memory* vm_acquire(pid_t pid){
+    pthread_rwlock_rdlock(&registry_lock);
+    virtual_memory* mem = vm_registry_get(manager, pid);
+    if(mem != NULL){
+        __sync_fetch_and_add(&mem->refs, 1);
+    }
+    pthread_rwlock_unlock(&registry_lock);
+    if(mem == NULL){
+        return NULL;
+    }
+
+    pthread_mutex_lock(&mem->lock);
+    if(mem->dead){
+        pthread_mutex_unlock(&mem->lock);
+        vm_put(mem);
+        return NULL;
+    }
+    mem->holder = pthread_self();
+    mem->held = 1;
+    return mem;
+}
+
+/**
+ * @brief Versão não bloqueante de "vm_acquire", utilizada por "reclaim_frame" para examinar páginas de outros processos
+ * enquanto detém "frame_lock". Caso o lock do processo esteja ocupado, a página é simplesmente ignorada nesta volta.
+ * 
+ * @param pid Identificador do processo
+ * @return virtual_memory* A memória virtual adquirida, ou NULL caso ela não exista ou seu lock esteja ocupado.
+ */
+virtual_memory* vm_try_acquire(pid_t pid){
+    pthread_rwlock_rdlock(&registry_lock);
+    virtual_memory* mem = vm_registry_get(manager, pid);
+    if(mem != NULL && pthread_mutex_trylock(&mem->lock) == 0){
+        if(mem->dead){
+            pthread_mutex_unlock(&mem->lock);
+            mem = NULL;
+        }
+        else{
+            __sync_fetch_and_add(&mem->refs, 1);
+            mem->holder = pthread_self();
+            mem->held = 1;
+        }
+    }
+    else{
+        mem = NULL;
+    }
+    pthread_rwlock_unlock(&registry_lock);
+    return mem;
+}
+
+/**
+ * @brief Libera o lock de uma memória virtual adquirida. Se o processo foi destruído enquanto o lock estava adquirido
+ * (a MMU chama "pager_destroy" quando a comunicação com o processo falha), suas páginas são liberadas neste momento. Caso
+ * contrário, os quadros ainda pendentes em "deferred" são registrados antes, de forma que nenhum quadro obtido de um magazine
+ * permaneça invisível à substituição depois da falha que o obteve.
+ * 
+ * @param mem Memória virtual adquirida pela thread atual
+ */
+void vm_unlock(virtual_memory* mem){
+    if(mem->dead && mem->page_table != NULL){
+        vm_teardown(mem);
+    }
+    else if(mem->deferred_count > 0){
+        frame_lock_process(mem);
+        pthread_mutex_unlock(&frame_lock);
+    }
+    mem->held = 0;
+    pthread_mutex_unlock(&mem->lock);
+    vm_put(mem);
+}
+
+//-------------------------- PAGER STATISTICS --------------------------------------------------------------------------
+
+/**
+ * @brief Contadores globais do paginador, atualizados de forma atômica.
+ * @param major_faults Páginas trazidas do disco.
+ * @param zero_fills Páginas preenchidas com zeros no primeiro acesso.
+ * @param evictions Páginas retiradas da memória principal.
+ * @param writebacks Páginas escritas no disco ao serem retiradas.
+ * @param direct_reclaims Páginas retiradas durante o tratamento de uma falha, por falta de quadros livres.
+ * @param cleaned Páginas escritas no disco em segundo plano, antes de serem retiradas.
+ * @param prefetched Páginas lidas antecipadamente do disco.
+ * @param prefetch_hits Páginas lidas antecipadamente que foram acessadas.
+ * @param faultaround Páginas vizinhas que tiveram a permissão devolvida pela falha em torno.
+ * @param cow_shared Páginas compartilhadas com processos criados por "pager_fork".
+ * @param cow_copies Quadros copiados na primeira escrita em uma página compartilhada.
+ * @param zero_maps Primeiros acessos de leitura atendidos pelo quadro de zeros compartilhado.
+ * @param dedup_scanned Quadros examinados pela deduplicação.
+ * @param dedup_merged Quadros liberados pela deduplicação, por terem o mesmo conteúdo de outro quadro.
+ * @param zswap_stores Páginas retiradas guardadas na área de troca comprimida, em vez de escritas no disco.
+ * @param zswap_loads Páginas trazidas da área de troca comprimida.
+ * @param released Páginas descartadas por "pager_release".
+ * @param pins Páginas fixadas na memória principal por "pager_lock".
+ * @param pin_skips Quadros fixados ignorados durante a busca por uma vítima.
+ * @param magazine_hits Quadros e blocos livres obtidos dos magazines das threads sem adquirir o lock da tabela (ver "page_magazine").
+ * @param magazine_refills Lotes de posições livres retirados das tabelas para os magazines.
+ * @param table_locks Aquisições de "frame_lock" ou "block_lock" feitas para obter um quadro ou um bloco com os magazines ligados
+ * (reposições e magazines sem posições). O registro dos quadros pendentes (ver "frame_flush") não é contado.
+ * @param cold_marked Páginas tornadas frias por "pager_advise" (UVM_ADV_COLD) ou pela varredura sequencial (ver "drop_behind").
+ * @param swap_failures Falhas de página não atendidas por falta de espaço de troca (fora do modo OVERCOMMIT_STRICT).
+ * @param swap_cache_hits Páginas já escritas retiradas sem escrita no disco, por estarem limpas desde a leitura do bloco ou a
+ * escrita em segundo plano.
+ * 
+ */
+typedef struct{
+    unsigned long major_faults;
+    unsigned long zero_fills;
+    unsigned long evictions;
+    unsigned long writebacks;
+    unsigned long direct_reclaims;
+    unsigned long cleaned;
+    unsigned long prefetched;
+    unsigned long prefetch_hits;
+    unsigned long faultaround;
+    unsigned long cow_shared;
+    unsigned long cow_copies;
+    unsigned long zero_maps;
+    unsigned long dedup_scanned;
+    unsigned long dedup_merged;
+    unsigned long zswap_stores;
+    unsigned long zswap_loads;
+    unsigned long swap_cache_hits;
+    unsigned long swap_failures;
+    unsigned long released;
+    unsigned long cold_marked;
+    unsigned long pins;
+    unsigned long pin_skips;
+    unsigned long magazine_hits;
+    unsigned long magazine_refills;
+    unsigned long table_locks;
+} pager_counters;
+
+pager_counters stats;
+
+/**
+ * @brief Se 1 (opção stats=1), os contadores são impressos sempre que o último processo é destruído.
+ * 
+ */
+int stats_report;
+
+/**
+ * @brief Imprime os contadores do paginador e a política de substituição em uso.
+ * 
+ */
+void stats_print(){
+    printf("pager_stats policy %s major %lu zero %lu evictions %lu writebacks %lu direct %lu cleaned %lu prefetched %lu hits %lu faultaround %lu cow %lu/%lu zeromaps %lu dedup %lu/%lu zswap %lu/%lu swapcache %lu noswap %lu released %lu cold %lu pinned %lu/%lu magazine %lu/%lu tablelocks %lu\n",
+        policy->name, stats.major_faults, stats.zero_fills, stats.evictions, stats.writebacks, stats.direct_reclaims, stats.cleaned,
+        stats.prefetched, stats.prefetch_hits, stats.faultaround, stats.cow_copies, stats.cow_shared,
+        stats.zero_maps, stats.dedup_merged, stats.dedup_scanned,
+        stats.zswap_stores, stats.zswap_loads, stats.swap_cache_hits, stats.swap_failures, stats.released, stats.cold_marked,
+        stats.pins, stats.pin_skips, stats.magazine_hits, stats.magazine_refills, stats.table_locks);
+}
+
+//------------------------------------ MAGAZINES --------------------------------------------------------
+
+/**
+ * @brief Capacidade máxima de cada magazine (opção magazine).
+ * 
+ */
+#define MAGAZINE_MAX 64
+
+/**
+ * @brief Magazine de uma thread: posições livres de "frame" e de "block" retiradas do mapa de bits em lotes de "magazine_size",
+ * com as quais a thread obtém um quadro ou um bloco sem adquirir o lock da tabela. As posições guardadas continuam contadas em
+ * "free" da tabela. Apenas a própria thread retira posições do magazine sem o lock ("magazine_get") e apenas ela acrescenta
+ * posições, com o lock da tabela adquirido ("magazine_refill" e "magazine_keep"); "magazine_flush_all" as devolve ao mapa de bits,
+ * também com o lock da tabela, quando ele se esgota. As retiradas e a devolução disputam "count" por comparação e troca.
+ * @param slots Posições guardadas de cada tabela (0 - "frame", 1 - "block"), em ordem decrescente
+ * @param count Quantidade de posições guardadas de cada tabela
+ * @param used Indica que a thread já obteve posições da tabela pelo magazine. Apenas essas threads guardam as posições que liberam.
+ * @param next Próximo magazine da lista "magazines"
+ * 
+ */
+typedef struct page_magazine{
+    int slots[2][MAGAZINE_MAX];
+    volatile int count[2];
+    int used[2];
+    struct page_magazine* next;
+} page_magazine;
+
+/**
+ * @brief Quantidade de posições retiradas do mapa de bits a cada reposição de um magazine (opção magazine=N). Com 0 (padrão) os
+ * magazines não são usados, e cada falha recebe o quadro livre de menor índice.
+ * 
+ */
+int magazine_size;
+/**
+ * @brief Chave do magazine de cada thread. Ao fim da thread, seu magazine é devolvido às tabelas (ver "magazine_destroy").
+ * 
+ */
+pthread_key_t magazine_key;
+/**
+ * @brief Lista de todos os magazines, protegida por "magazine_lock" (adquirido depois de "frame_lock" e "block_lock").
+ * 
+ */
+page_magazine* magazines;
+pthread_mutex_t magazine_lock;
+
+/**
+ * @brief Índice das posições da tabela em "slots" e "count".
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @return int 0 - "frame". 1 - "block".
+ */
+static inline int magazine_index(page_central* central){
+    return central == &frame ? 0 : 1;
+}
+
+/**
+ * @brief Lock que protege a tabela.
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @return pthread_mutex_t* "frame_lock" ou "block_lock"
+ */
+static inline pthread_mutex_t* magazine_table_lock(page_central* central){
+    return central == &frame ? &frame_lock : &block_lock;
+}
+
+/**
+ * @brief Devolve ao mapa de bits as posições da tabela guardadas no magazine, disputando-as com as retiradas da thread dona. Deve
+ * ser chamada com o lock da tabela adquirido.
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @param mag Magazine
+ */
+void magazine_return(page_central* central, page_magazine* mag){
+    int t = magazine_index(central);
+    int batch[MAGAZINE_MAX];
+    int count;
+    do{
+        count = mag->count[t];
+        for(int i = 0; i < count; i++){
+            batch[i] = mag->slots[t][i];
+        }
+    }while(!__sync_bool_compare_and_swap(&mag->count[t], count, 0));
+    for(int i = 0; i < count; i++){
+        page_central_unclaim(central, batch[i]);
+    }
+}
+
+/**
+ * @brief Devolve ao mapa de bits as posições da tabela guardadas em todos os magazines. Deve ser chamada com o lock da tabela
+ * adquirido.
+ * 
+ * @param central Tabela ("frame" ou "block")
+ */
+void magazine_flush_all(page_central* central){
+    pthread_mutex_lock(&magazine_lock);
+    for(page_magazine* mag = magazines; mag != NULL; mag = mag->next){
+        magazine_return(central, mag);
+    }
+    pthread_mutex_unlock(&magazine_lock);
+}
+
+/**
+ * @brief Destrutor da chave "magazine_key": devolve às tabelas as posições do magazine de uma thread que terminou e o remove da
+ * lista.
+ * 
+ * @param arg Magazine da thread
+ */
+void magazine_destroy(void* arg){
+    page_magazine* mag = (page_magazine*) arg;
+    pthread_mutex_lock(&frame_lock);
+    pthread_mutex_lock(&block_lock);
+    pthread_mutex_lock(&magazine_lock);
+    magazine_return(&frame, mag);
+    magazine_return(&block, mag);
+    page_magazine** link = &magazines;
+    while(*link != mag){
+        link = &(*link)->next;
+    }
+    *link = mag->next;
+    pthread_mutex_unlock(&magazine_lock);
+    pthread_mutex_unlock(&block_lock);
+    pthread_mutex_unlock(&frame_lock);
+    free(mag);
+}
+
+/**
+ * @brief Obtém o magazine da thread atual, criando-o no primeiro uso.
+ * 
+ * @return page_magazine* Magazine da thread
+ */
+page_magazine* magazine_self(){
+    page_magazine* mag = (page_magazine*) pthread_getspecific(magazine_key);
+    if(mag == NULL){
+        mag = (page_magazine*) calloc(1, sizeof(page_magazine));
+        pthread_mutex_lock(&magazine_lock);
+        mag->next = magazines;
+        magazines = mag;
+        pthread_mutex_unlock(&magazine_lock);
+        pthread_setspecific(magazine_key, mag);
+    }
+    return mag;
+}
+
+/**
+ * @brief Retira uma posição livre da tabela do magazine da thread atual, sem adquirir nenhum lock. A posição retirada continua
+ * contada em "free" até ser ocupada com "magazine_place".
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @return int A posição retirada, ou -1 caso os magazines estejam desligados ou o magazine esteja vazio (ver "magazine_refill").
+ */
+int magazine_get(page_central* central){
+    if(magazine_size == 0){
+        return -1;
+    }
+    page_magazine* mag = magazine_self();
+    int t = magazine_index(central);
+    mag->used[t] = 1;
+    while(1){
+        int count = mag->count[t];
+        if(count == 0){
+            return -1;
+        }
+        int pos = mag->slots[t][count - 1];
+        if(__sync_bool_compare_and_swap(&mag->count[t], count, count - 1)){
+            return pos;
+        }
+    }
+}
+
+/**
+ * @brief Repõe o magazine vazio da thread atual com até "magazine_size" posições de menor índice do mapa de bits, em uma única
+ * aquisição do lock da tabela, e retira dele uma posição. Deve ser chamada com o lock da tabela adquirido.
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @return int A posição retirada, ou -1 caso os magazines estejam desligados ou o mapa de bits esteja vazio.
+ */
+int magazine_refill(page_central* central){
+    if(magazine_size == 0){
+        return -1;
+    }
+    page_magazine* mag = magazine_self();
+    int t = magazine_index(central);
+    int batch[MAGAZINE_MAX + 1];
+    int count = 0;
+    while(count <= magazine_size && mag->count[t] + count <= MAGAZINE_MAX){
+        int pos = page_central_find_free(central);
+        if(pos == -1){
+            break;
+        }
+        page_central_claim(central, pos);
+        batch[count++] = pos;
+    }
+    if(count == 0){
+        return -1;
+    }
+    // O lote é guardado em ordem decrescente, para que as posições sejam retiradas a partir da de menor índice.
+    for(int i = 1; i < count; i++){
+        mag->slots[t][mag->count[t]] = batch[count - i];
+        __sync_fetch_and_add(&mag->count[t], 1);
+    }
+    __sync_fetch_and_add(&stats.magazine_refills, 1);
+    return batch[0];
+}
+
+/**
+ * @brief Obtém uma posição livre da tabela pelo magazine da thread atual, adquirindo o lock da tabela apenas para repô-lo. Para os
+ * blocos, pode ser chamada com "frame_lock" adquirido.
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @return int A posição obtida, ou -1 caso os magazines estejam desligados ou o mapa de bits esteja vazio.
+ */
+int magazine_alloc(page_central* central){
+    int pos = magazine_get(central);
+    if(pos != -1){
+        __sync_fetch_and_add(&stats.magazine_hits, 1);
+    }
+    else if(magazine_size != 0 && central->free > 0){
+        pthread_mutex_t* lock = magazine_table_lock(central);
+        pthread_mutex_lock(lock);
+        __sync_fetch_and_add(&stats.table_locks, 1);
+        pos = magazine_refill(central);
+        pthread_mutex_unlock(lock);
+    }
+    return pos;
+}
+
+/**
+ * @brief Ocupa com a página uma posição obtida por "magazine_get", "magazine_refill" ou "magazine_alloc".
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @param pos Posição retirada do magazine
+ * @param new_page Página que ocupará a posição
+ */
+void magazine_place(page_central* central, int pos, page new_page){
+    __sync_fetch_and_sub(&central->free, 1);
+    place_page(central, pos, new_page);
+}
+
+/**
+ * @brief Reserva uma posição livre da tabela para a página informada: a próxima do magazine da thread atual, repondo-o se estiver
+ * vazio, ou, com os magazines desligados ou sem posições no mapa de bits, a obtida por "page_central_alloc". Deve ser chamada com o
+ * lock da tabela adquirido.
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @param new_page Página que ocupará a posição
+ * @return int A posição reservada, ou -1 caso a tabela esteja cheia.
+ */
+int magazine_page_alloc(page_central* central, page new_page){
+    int pos = magazine_get(central);
+    if(pos == -1){
+        pos = magazine_refill(central);
+    }
+    if(pos == -1){
+        return page_central_alloc(central, new_page);
+    }
+    magazine_place(central, pos, new_page);
+    return pos;
+}
+
+/**
+ * @brief Guarda no magazine da thread atual uma posição liberada, caso a thread obtenha posições da tabela pelo magazine e ele não
+ * esteja cheio (até o dobro de "magazine_size"). Deve ser chamada com o lock da tabela adquirido, que "page_central_release" já
+ * detém; por isso, ao contrário de "magazine_get", a inclusão não usa CAS: as devoluções de "magazine_flush_all", únicas
+ * alterações feitas por outras threads, também exigem esse lock.
+ * 
+ * @param central Tabela ("frame" ou "block")
+ * @param pos Posição liberada, ainda marcada como ocupada no mapa de bits
+ * @return int 1 - Quando a posição foi guardada. 0 - Quando ela deve voltar ao mapa de bits.
+ */
+int magazine_keep(page_central* central, int pos){
+    if(magazine_size == 0){
+        return 0;
+    }
+    page_magazine* mag = (page_magazine*) pthread_getspecific(magazine_key);
+    int t = magazine_index(central);
+    int capacity = 2 * magazine_size < MAGAZINE_MAX ? 2 * magazine_size : MAGAZINE_MAX;
+    if(mag == NULL || !mag->used[t] || mag->count[t] >= capacity){
+        return 0;
+    }
+    mag->slots[t][mag->count[t]] = pos;
+    __sync_fetch_and_add(&mag->count[t], 1);
+    return 1;
+}
+
+//------------------------------------ RESIDENT SET --------------------------------------------------------
+
+/**
+ * @brief Anéis de quadros de cada processo, encadeados pelos vetores "rs_next" e "rs_prev" (indexados pelo quadro) e protegidos
+ * por "frame_lock". Permitem percorrer apenas os quadros de um processo durante a substituição local.
+ * 
+ */
+int* rs_next;
+int* rs_prev;
+
+/**
+ * @brief Limiar do algoritmo PFF (Page Fault Frequency), em páginas trazidas para a memória principal por todos os processos
+ * (opção pff=T). Se um processo traz uma página menos de T páginas depois da anterior, seu orçamento de quadros aumenta; caso
+ * contrário diminui, até PFF_MIN_BUDGET. Um processo que já ocupa todo o seu orçamento substitui suas próprias páginas, e a
+ * substituição global prefere processos acima do orçamento. Com T igual a 0 (padrão) não há orçamentos.
+ * 
+ */
+unsigned long pff_threshold;
+unsigned long pff_clock;
+
+/**
+ * @brief Tamanho máximo da janela de leitura antecipada (opção readahead=N). Com 0 (padrão) não há leitura antecipada.
+ * 
+ */
+int readahead_max;
+
+/**
+ * @brief Tamanho do bloco de páginas considerado pela falha em torno (opção faultaround=K). Com 0 (padrão) não há falha em torno.
+ * 
+ */
+int faultaround_pages;
+
+/**
+ * @brief Tamanho máximo do bloco da falha em torno (opção faultaround): o bloco alinhado fica dentro de uma única folha da tabela de
+ * páginas.
+ * 
+ */
+#define FAULTAROUND_MAX PT_FANOUT
+
+/**
+ * @brief Insere o quadro no anel de quadros do processo.
+ * 
+ * @param mem Memória virtual do processo
+ * @param pos Quadro
+ */
+void resident_link(virtual_memory* mem, int pos){
+    if(mem->resident_head == -1){
+        rs_next[pos] = rs_prev[pos] = pos;
+        mem->resident_head = pos;
+    }
+    else{
+        int head = mem->resident_head;
+        rs_next[pos] = head;
+        rs_prev[pos] = rs_prev[head];
+        rs_next[rs_prev[head]] = pos;
+        rs_prev[head] = pos;
+    }
+    mem->resident++;
+}
+
+/**
+ * @brief Retira o quadro do anel de quadros do processo.
+ * 
+ * @param mem Memória virtual do processo
+ * @param pos Quadro
+ */
+void resident_unlink(virtual_memory* mem, int pos){
+    if(rs_next[pos] == pos){
+        mem->resident_head = -1;
+    }
+    else{
+        rs_next[rs_prev[pos]] = rs_next[pos];
+        rs_prev[rs_next[pos]] = rs_prev[pos];
+        if(mem->resident_head == pos){
+            mem->resident_head = rs_next[pos];
+        }
+    }
+    mem->resident--;
+}
+
+/**
+ * @brief Próximo candidato da substituição local: o ponteiro do processo ("resident_head") avança uma posição em seu anel.
+ * 
+ * @param mem Memória virtual do processo
+ * @return int O quadro candidato, ou -1 caso o processo não ocupe nenhum quadro.
+ */
+int resident_pick_victim(virtual_memory* mem){
+    int pos = mem->resident_head;
+    if(pos != -1){
+        mem->resident_head = rs_next[pos];
+    }
+    return pos;
+}
+
+/**
+ * @brief Quantidade de quadros ocupados pelo processo, incluindo os ainda pendentes em "deferred".
+ * 
+ * @param mem Memória virtual do processo
+ * @return int Quantidade de quadros
+ */
+static inline int resident_count(virtual_memory* mem){
+    return mem->resident + mem->deferred_count;
+}
+
+/**
+ * @brief Atualiza o orçamento de quadros do processo a cada página trazida para a memória principal, segundo o algoritmo PFF.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @return int 1 se o processo deve substituir uma de suas próprias páginas, 0 caso contrário.
+ */
+int pff_update(virtual_memory* mem){
+    if(pff_threshold == 0){
+        return 0;
+    }
+    unsigned long now = __sync_add_and_fetch(&pff_clock, 1);
+    if(mem->last_fault != 0 && now - mem->last_fault < pff_threshold){
+        if(mem->budget < frame.size){
+            mem->budget++;
+        }
+    }
+    else if(mem->budget > PFF_MIN_BUDGET){
+        mem->budget--;
+    }
+    mem->last_fault = now;
+    return resident_count(mem) >= mem->budget;
+}
+
+/**
+ * @brief Verifica se o processo ocupa todos os quadros permitidos por seu limite (ver "pager_setlimit"), caso em que suas falhas
+ * substituem suas próprias páginas em vez de ocupar quadros livres ou de outros processos.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @return int 1 se o processo deve substituir uma de suas próprias páginas, 0 caso contrário.
+ */
+int resident_limited(virtual_memory* mem){
+    unsigned long limit = mem->limits[UVM_LIMIT_RESIDENT];
+    return limit != 0 && (unsigned long) resident_count(mem) >= limit;
+}
+
+/**
+ * @brief Inclui o quadro recém-ocupado no anel do processo e informa a política. Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @param mem Memória virtual do processo dono da página
+ * @param pos Quadro ocupado
+ */
+void frame_attach(virtual_memory* mem, int pos){
+    resident_link(mem, pos);
+    if(policy->on_fault != NULL){
+        policy->on_fault(pos);
+    }
+}
+
+/**
+ * @brief Reserva o quadro livre de menor índice para a página, informando a política. Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @param mem Memória virtual do processo dono da página
+ * @param new_page Página que ocupará o quadro
+ * @return int O quadro reservado, ou -1 caso não haja quadros livres.
+ */
+int frame_alloc(virtual_memory* mem, page new_page){
+    int pos = page_central_alloc(&frame, new_page);
+    if(pos != -1){
+        frame_attach(mem, pos);
+    }
+    return pos;
+}
+
+/**
+ * @brief Registra em "frame.page_t", no anel do processo e na política os quadros pendentes em "deferred". Deve ser chamada com
+ * "frame_lock" adquirido.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ */
+void frame_flush(virtual_memory* mem){
+    for(int i = 0; i < mem->deferred_count; i++){
+        int pos = mem->deferred[i].entry->frame;
+        place_page(&frame, pos, mem->deferred[i]);
+        frame_attach(mem, pos);
+    }
+    mem->deferred_count = 0;
+}
+
+/**
+ * @brief Adquire "frame_lock" para operar sobre os quadros do processo, registrando antes seus quadros pendentes (ver
+ * "frame_flush"). Utilizada no lugar de "pthread_mutex_lock(&frame_lock)" sempre que um processo está adquirido pela thread atual.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual, ou NULL
+ */
+void frame_lock_process(virtual_memory* mem){
+    pthread_mutex_lock(&frame_lock);
+    if(mem != NULL){
+        frame_flush(mem);
+    }
+}
+
+/**
+ * @brief Ocupa com a página um quadro retirado do magazine da thread, sem adquirir "frame_lock": apenas a entrada da tabela de
+ * páginas, protegida pelo lock do processo, recebe o quadro, e a página fica pendente em "deferred" até a próxima aquisição de
+ * "frame_lock" pelo processo (ver "frame_lock_process"), que ocorre no mais tardar ao liberá-lo ("vm_unlock"), ao fim da falha.
+ * Enquanto isso o quadro não aparece em "frame.page_t" e não pode ser escolhido como vítima; a falha apenas adia o registro para
+ * depois das chamadas à MMU, agrupando os quadros que obteve em uma única aquisição de "frame_lock".
+ * 
+ * @param mem Memória virtual do processo dono da página, adquirida pela thread atual
+ * @param pos Quadro retirado do magazine
+ * @param new_page Página que ocupará o quadro
+ */
+void frame_defer(virtual_memory* mem, int pos, page new_page){
+    if(mem->deferred == NULL){
+        mem->deferred = (page*) malloc(sizeof(page) * MAGAZINE_MAX);
+    }
+    else if(mem->deferred_count == MAGAZINE_MAX){
+        frame_lock_process(mem);
+        pthread_mutex_unlock(&frame_lock);
+    }
+    __sync_fetch_and_sub(&frame.free, 1);
+    new_page.entry->frame = pos;
+    mem->deferred[mem->deferred_count++] = new_page;
+}
+
+//------------------------------------ COPY ON WRITE --------------------------------------------------------
+
+/**
+ * @brief Processos que mapeiam um quadro compartilhado após "pager_fork" ou a deduplicação (mapeamento reverso). Todos mapeiam a
+ * página sem permissão de escrita, cada um em seu endereço virtual. Um deles é o ocupante registrado em "frame.page_t", em cujo anel
+ * de quadros o quadro está.
+ * @param mems Memória virtual de cada processo
+ * @param entries Entrada da tabela de páginas de cada processo
+ * @param vaddrs Endereço virtual da página em cada processo
+ * @param count Quantidade de processos, ou 0 quando o quadro não está compartilhado
+ * @param capacity Capacidade dos vetores
+ * 
+ */
+typedef struct{
+    virtual_memory** mems;
+    page_entry** entries;
+    void** vaddrs;
+    int count;
+    int capacity;
+} frame_share;
+
+/**
+ * @brief Compartilhamento de cada quadro, protegido por "frame_lock".
+ * 
+ */
+frame_share* frame_shares;
+
+/**
+ * @brief Referências adicionais a cada bloco (0 quando apenas uma página o utiliza), protegido por "block_lock". Um bloco
+ * compartilhado não tem ocupante registrado em "block.page_t".
+ * 
+ */
+int* block_shares;
+
+/**
+ * @brief Soma de "block_shares": blocos livres reservados para as cópias privadas que as escritas em páginas compartilhadas podem
+ * exigir. "pager_extend" e "pager_fork" só utilizam os blocos livres além dessa reserva. Protegido por "block_lock". Fora do modo
+ * OVERCOMMIT_STRICT não há reserva: a cópia privada recebe um bloco apenas ao ser retirada, como as demais páginas.
+ * 
+ */
+int cow_reserve;
+
+/**
+ * @brief Indica que algum quadro ou bloco já foi compartilhado, de forma que a destruição de um processo precisa consultar
+ * "cow_teardown". Protegido por "frame_lock".
+ * 
+ */
+int cow_used;
+
+/**
+ * @brief Acrescenta um processo aos que mapeiam o quadro. Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @param pos Quadro
+ * @param mem Memória virtual do processo
+ * @param entry Entrada da tabela de páginas do processo
+ * @param vaddr Endereço virtual da página no processo
+ */
+void frame_share_add(int pos, virtual_memory* mem, page_entry* entry, void* vaddr){
+    frame_share* share = &frame_shares[pos];
+    if(share->count == share->capacity){
+        share->capacity = share->capacity ? 2 * share->capacity : 4;
+        share->mems = (virtual_memory**) realloc(share->mems, sizeof(virtual_memory*) * share->capacity);
+        share->entries = (page_entry**) realloc(share->entries, sizeof(page_entry*) * share->capacity);
+        share->vaddrs = (void**) realloc(share->vaddrs, sizeof(void*) * share->capacity);
+    }
+    share->mems[share->count] = mem;
+    share->entries[share->count] = entry;
+    share->vaddrs[share->count] = vaddr;
+    share->count++;
+    cow_used = 1;
+}
+
+/**
+ * @brief Busca a página entre as que mapeiam o quadro. Um mesmo processo pode mapear o quadro em mais de um endereço, caso páginas
+ * suas tenham sido unidas pela deduplicação. Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @param pos Quadro
+ * @param entry Entrada da tabela de páginas
+ * @return int A posição da página em "frame_shares[pos]", ou -1 caso ela não mapeie o quadro compartilhado.
+ */
+int frame_share_find(int pos, page_entry* entry){
+    for(int i = 0; i < frame_shares[pos].count; i++){
+        if(frame_shares[pos].entries[i] == entry){
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Retira a página das que mapeiam o quadro, sem alterar sua entrada da tabela de páginas. Se ela era o ocupante registrado,
+ * o quadro passa a outra página (e ao anel de quadros de seu processo). Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @param pos Quadro
+ * @param entry Entrada da tabela de páginas
+ */
+void frame_share_remove(int pos, page_entry* entry){
+    frame_share* share = &frame_shares[pos];
+    int i = frame_share_find(pos, entry);
+    virtual_memory* mem = share->mems[i];
+    share->count--;
+    share->mems[i] = share->mems[share->count];
+    share->entries[i] = share->entries[share->count];
+    share->vaddrs[i] = share->vaddrs[share->count];
+    if(frame.page_t[pos].entry == entry){
+        resident_unlink(mem, pos);
+        resident_link(share->mems[0], pos);
+        frame.page_t[pos].pid = share->mems[0]->pid;
+        frame.page_t[pos].vaddr = share->vaddrs[0];
+        frame.page_t[pos].entry = share->entries[0];
+    }
+    if(share->count == 1){
+        share->count = 0;
+    }
+}
+
+/**
+ * @brief Desfaz o compartilhamento de um quadro retirado da memória principal: as entradas dos processos que não são o ocupante
+ * registrado deixam de apontar para ele (a do ocupante é tratada por "clean_page"). Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @param pos Quadro
+ */
+void frame_share_clear(int pos){
+    frame_share* share = &frame_shares[pos];
+    for(int i = 0; i < share->count; i++){
+        if(share->entries[i] != frame.page_t[pos].entry){
+            share->entries[i]->frame = -1;
+        }
+    }
+    share->count = 0;
+}
+
+/**
+ * @brief Retira o processo que está sendo destruído dos quadros e blocos que ele compartilha, de forma que "page_table_destroy"
+ * libere apenas as posições exclusivas dele. Deve ser chamada com "frame_lock" e "block_lock" adquiridos.
+ * 
+ * @param mem Memória virtual do processo
+ */
+void cow_teardown(virtual_memory* mem){
+    if(!cow_used){
+        return;
+    }
+    for(long index = 0; index <= mem->page_ptr; index++){
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(entry == NULL || !entry->options.cow){
+            continue;
+        }
+        if(entry->frame != -1 && frame_shares[entry->frame].count > 0 && frame_share_find(entry->frame, entry) != -1){
+            frame_share_remove(entry->frame, entry);
+            entry->frame = -1;
+        }
+        if(entry->block != -1 && block_shares[entry->block] > 0){
+            block_shares[entry->block]--;
+            if(overcommit_mode == OVERCOMMIT_STRICT){
+                cow_reserve--;
+            }
+            entry->block = -1;
+        }
+    }
+}
+
+//------------------------------------ ZERO FRAME --------------------------------------------------------
+
+/**
+ * @brief Se 1 (opção zeropage=1), o primeiro acesso de leitura a uma página nova mapeia o quadro de zeros compartilhado, e um quadro
+ * próprio só é ocupado e preenchido na primeira escrita.
+ * 
+ */
+int zero_frame_enabled;
+/**
+ * @brief Quadro preenchido com zeros mapeado somente para leitura por todos os processos, ou -1 enquanto nenhuma página o mapeou.
+ * É reservado sem ocupante no primeiro mapeamento (ver "zero_frame_reserve"), de forma que nunca é escolhido como vítima.
+ * 
+ */
+int zero_frame = -1;
+/**
+ * @brief Serializa a reserva de "zero_frame". É adquirido antes de "frame_lock".
+ * 
+ */
+pthread_mutex_t zero_frame_lock;
+
+/**
+ * @brief Reserva o quadro de zeros caso ainda não exista: o último quadro quando livre ou, caso contrário, o quadro livre de menor
+ * índice, que é preenchido com zeros. Sem nenhum quadro livre, nada é reservado, e a próxima página nova tenta novamente.
+ * 
+ * @return int 0 - Quando o quadro de zeros existe. -1 - Caso contrário.
+ */
+int zero_frame_reserve(){
+    if(zero_frame != -1){
+        return 0;
+    }
+    pthread_mutex_lock(&zero_frame_lock);
+    if(zero_frame == -1 && frame.size > 1){
+        pthread_mutex_lock(&frame_lock);
+        int pos = frame.size - 1;
+        if(frame.free_map[pos / 64] & ((uint64_t) 1 << (pos % 64))){
+            page_central_take(&frame, pos);
+        }
+        else{
+            pos = page_central_grab(&frame);
+        }
+        pthread_mutex_unlock(&frame_lock);
+        if(pos != -1){
+            mmu_zero_fill(pos);
+            __sync_synchronize();
+            zero_frame = pos;
+        }
+    }
+    pthread_mutex_unlock(&zero_frame_lock);
+    return zero_frame != -1 ? 0 : -1;
+}
+
+/**
+ * @brief Primeiro acesso de leitura a uma página nova: mapeia no processo o quadro de zeros, sem ocupar nenhum quadro.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param vaddr Endereço virtual inicial da página
+ * @param entry Entrada da tabela de páginas, no estado PAGE_EXTENDED
+ * @return int 0 - Quando a página foi mapeada. -1 - Quando o quadro de zeros não pôde ser reservado; a página deve ser trazida
+ * por "page_in".
+ */
+int zero_map(virtual_memory* mem, void* vaddr, page_entry* entry){
+    if(zero_frame_reserve() == -1){
+        return -1;
+    }
+    entry->options.zero = 1;
+    entry->options.write_op = 0;
+    entry->options.dirty = 0;
+    entry->options.permission = PROT_READ;
+    entry->options.reference_bit = 1;
+    __sync_fetch_and_add(&stats.zero_maps, 1);
+    mmu_resident(mem->pid, vaddr, zero_frame, PROT_READ);
+    return 0;
+}
+
+//------------------------------------ COMPRESSED SWAP --------------------------------------------------------
+
+/**
+ * @brief Capacidade, em páginas, da área de troca comprimida em memória (opção zswap=N). Desligada (0) por padrão.
+ * 
+ */
+int zswap_pages;
+/**
+ * @brief Conteúdo comprimido de cada bloco, ou NULL quando o conteúdo do bloco está no disco. Como cada página possui um bloco
+ * reservado desde "pager_extend", o bloco identifica a página na área comprimida, inclusive quando compartilhado após "pager_fork".
+ * Protegido por "block_lock".
+ * 
+ */
+unsigned char** zswap_data;
+/**
+ * @brief Tamanho do conteúdo comprimido de cada bloco. Protegido por "block_lock".
+ * 
+ */
+int* zswap_len;
+/**
+ * @brief Bytes ocupados pela área comprimida, limitados a "zswap_pages" páginas. Protegido por "block_lock".
+ * 
+ */
+long zswap_used;
+/**
+ * @brief Buffer de uma página de cada thread, onde os quadros são comprimidos e descomprimidos (ver "zswap_buffer").
+ * 
+ */
+pthread_key_t zswap_key;
+
+#define LZ_HASH_BITS 12
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+
+/**
+ * @brief Escreve um comprimento no formato LZ77 do paginador: 7 bits por byte, com o bit mais significativo indicando continuação.
+ * 
+ * @param dst Saída
+ * @param op Posição de escrita
+ * @param cap Capacidade da saída
+ * @param len Comprimento
+ * @return int A nova posição de escrita, ou -1 caso a saída esteja cheia.
+ */
+int lz_put_len(unsigned char* dst, int op, int cap, int len){
+    for(; len >= 128; len >>= 7){
+        if(op >= cap){
+            return -1;
+        }
+        dst[op++] = (unsigned char) (len | 128);
+    }
+    if(op >= cap){
+        return -1;
+    }
+    dst[op++] = (unsigned char) len;
+    return op;
+}
+
+/**
+ * @brief Lê um comprimento escrito por "lz_put_len".
+ * 
+ * @param src Entrada
+ * @param ip Posição de leitura, avançada após o comprimento
+ * @param len Tamanho da entrada
+ * @return int O comprimento, ou -1 caso a entrada termine antes dele.
+ */
+int lz_get_len(const unsigned char* src, int* ip, int len){
+    int value = 0;
+    for(int shift = 0; *ip < len && shift < 28; shift += 7){
+        unsigned char byte = src[(*ip)++];
+        value |= (byte & 127) << shift;
+        if(!(byte & 128)){
+            return value;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Comprime "len" bytes com LZ77. A saída é uma sequência de pares (literais, cópia): o comprimento dos literais seguido
+ * deles, e o comprimento da cópia seguido da distância em 2 bytes; uma cópia de comprimento 0 encerra a saída. As cópias são
+ * encontradas por uma tabela hash da última posição de cada sequência de LZ_MIN_MATCH bytes, e podem se sobrepor ao trecho
+ * copiado, de forma que páginas preenchidas com um único padrão ocupam poucos bytes.
+ * 
+ * @param src Entrada
+ * @param len Tamanho da entrada
+ * @param dst Saída
+ * @param cap Capacidade da saída
+ * @return int O tamanho comprimido, ou -1 caso não caiba em "cap" bytes.
+ */
+int lz_compress(const unsigned char* src, int len, unsigned char* dst, int cap){
+    int table[1 << LZ_HASH_BITS];
+    for(int i = 0; i < (1 << LZ_HASH_BITS); i++){
+        table[i] = -1;
+    }
+    int ip = 0;
+    int anchor = 0;
+    int op = 0;
+    while(ip + LZ_MIN_MATCH <= len){
+        uint32_t sequence;
+        memcpy(&sequence, src + ip, sizeof(sequence));
+        int hash = (sequence * 2654435761u) >> (32 - LZ_HASH_BITS);
+        int ref = table[hash];
+        table[hash] = ip;
+        if(ref < 0 || ip - ref > LZ_MAX_OFFSET || memcmp(src + ref, src + ip, LZ_MIN_MATCH) != 0){
+            ip++;
+            continue;
+        }
+        int match = LZ_MIN_MATCH;
+        while(ip + match < len && src[ref + match] == src[ip + match]){
+            match++;
+        }
+        op = lz_put_len(dst, op, cap, ip - anchor);
+        if(op < 0 || op + (ip - anchor) > cap){
+            return -1;
+        }
+        memcpy(dst + op, src + anchor, ip - anchor);
+        op += ip - anchor;
+        op = lz_put_len(dst, op, cap, match);
+        if(op < 0 || op + 2 > cap){
+            return -1;
+        }
+        dst[op++] = (unsigned char) ((ip - ref) & 255);
+        dst[op++] = (unsigned char) ((ip - ref) >> 8);
+        ip += match;
+        anchor = ip;
+    }
+    op = lz_put_len(dst, op, cap, len - anchor);
+    if(op < 0 || op + (len - anchor) > cap){
+        return -1;
+    }
+    memcpy(dst + op, src + anchor, len - anchor);
+    op += len - anchor;
+    return lz_put_len(dst, op, cap, 0);
+}
+
+/**
+ * @brief Descomprime a saída de "lz_compress".
+ * 
+ * @param src Entrada comprimida
+ * @param len Tamanho da entrada
+ * @param dst Saída
+ * @param cap Capacidade da saída
+ * @return int O tamanho descomprimido, ou -1 caso a entrada seja inválida.
+ */
+int lz_decompress(const unsigned char* src, int len, unsigned char* dst, int cap){
+    int ip = 0;
+    int op = 0;
+    while(1){
+        int literals = lz_get_len(src, &ip, len);
+        if(literals < 0 || ip + literals > len || op + literals > cap){
+            return -1;
+        }
+        memcpy(dst + op, src + ip, literals);
+        ip += literals;
+        op += literals;
+        int match = lz_get_len(src, &ip, len);
+        if(match <= 0){
+            return match == 0 ? op : -1;
+        }
+        if(ip + 2 > len){
+            return -1;
+        }
+        int offset = src[ip] | (src[ip + 1] << 8);
+        ip += 2;
+        if(offset == 0 || offset > op || op + match > cap){
+            return -1;
+        }
+        for(int i = 0; i < match; i++, op++){
+            dst[op] = dst[op - offset];
+        }
+    }
+}
+
+/**
+ * @brief Descarta o conteúdo comprimido do bloco, caso exista. Deve ser chamada com "block_lock" adquirido.
+ * 
+ * @param block_pos Bloco
+ */
+void zswap_drop(int block_pos){
+    if(zswap_data == NULL || zswap_data[block_pos] == NULL){
+        return;
+    }
+    zswap_used -= zswap_len[block_pos];
+    free(zswap_data[block_pos]);
+    zswap_data[block_pos] = NULL;
+    zswap_len[block_pos] = 0;
+}
+
+/**
+ * @brief Retorna o buffer de uma página da thread atual, alocado em seu primeiro uso e liberado quando a thread termina.
+ * 
+ * @return unsigned char* O buffer, ou NULL caso não haja memória para alocá-lo.
+ */
+unsigned char* zswap_buffer(){
+    unsigned char* buf = (unsigned char*) pthread_getspecific(zswap_key);
+    if(buf == NULL){
+        buf = (unsigned char*) malloc(PAGE_SIZE);
+        if(buf != NULL){
+            pthread_setspecific(zswap_key, buf);
+        }
+    }
+    return buf;
+}
+
+/**
+ * @brief Guarda o quadro comprimido na área de troca em memória, no lugar da escrita no bloco do disco. Quando o quadro não se
+ * comprime a menos de uma página ou a área está cheia, nada é guardado e o conteúdo anterior do bloco na área é descartado, de
+ * forma que o chamador deve escrever o quadro no disco. O quadro é comprimido no buffer da thread (ver "zswap_buffer"), e apenas
+ * os bytes comprimidos são alocados na área, depois de aceitos. Deve ser chamada sem "block_lock".
+ * 
+ * @param pos Quadro
+ * @param block_pos Bloco reservado para a página
+ * @return int 1 - Quando o quadro foi guardado. 0 - Caso contrário.
+ */
+int zswap_store(int pos, int block_pos){
+    if(zswap_pages == 0){
+        return 0;
+    }
+    long page_size = PAGE_SIZE;
+    unsigned char* buf = zswap_buffer();
+    int len = buf != NULL ? lz_compress((const unsigned char*) pmem + pos * page_size, page_size, buf, page_size - 1) : 0;
+
+    pthread_mutex_lock(&block_lock);
+    zswap_drop(block_pos);
+    unsigned char* data = NULL;
+    if(len > 0 && zswap_used + len <= (long) zswap_pages * page_size){
+        data = (unsigned char*) malloc(len);
+    }
+    if(data != NULL){
+        memcpy(data, buf, len);
+        zswap_data[block_pos] = data;
+        zswap_len[block_pos] = len;
+        zswap_used += len;
+    }
+    pthread_mutex_unlock(&block_lock);
+
+    if(data != NULL){
+        __sync_fetch_and_add(&stats.zswap_stores, 1);
+    }
+    return data != NULL;
+}
+
+/**
+ * @brief Se 1 (opção swapcache=1), o bloco do disco continua válido após a leitura da página: ela passa a estar limpa até a primeira
+ * escrita, de forma que sua retirada antes disso não precisa escrevê-la novamente no disco.
+ * 
+ */
+int swap_cache_enabled;
+
+/**
+ * @brief Lê para o quadro o conteúdo guardado da página: da área comprimida quando presente ou, caso contrário, do bloco do disco.
+ * O conteúdo comprimido é descartado ao ser lido, e a página passa a estar suja (o bloco do disco pode ser antigo), exceto quando
+ * o bloco está compartilhado após "pager_fork" ou a página é lida antecipadamente: nesses casos a área continua sendo a cópia
+ * válida para as demais páginas ou para uma retirada sem escrita. Com o cache de troca, a página lida do disco passa a estar limpa.
+ * 
+ * @param entry Entrada da tabela de páginas, cujo processo está adquirido pela thread atual
+ * @param pos Quadro de destino
+ */
+void swap_read(page_entry* entry, int pos){
+    unsigned char* buf = NULL;
+    if(zswap_pages > 0){
+        pthread_mutex_lock(&block_lock);
+        if(zswap_data[entry->block] != NULL){
+            buf = zswap_buffer();
+            assert(buf != NULL);
+            int len = lz_decompress(zswap_data[entry->block], zswap_len[entry->block], buf, PAGE_SIZE);
+            // Uma entrada que não volta a ter exatamente uma página está corrompida: carregá-la deixaria no quadro o conteúdo
+            // anterior do buffer.
+            assert(len == PAGE_SIZE);
+            if(!entry->options.prefetched && block_shares[entry->block] == 0){
+                zswap_drop(entry->block);
+                entry->options.dirty = 1;
+            }
+        }
+        pthread_mutex_unlock(&block_lock);
+    }
+    if(buf != NULL){
+        __sync_fetch_and_add(&stats.zswap_loads, 1);
+        mmu_load_frame((const char*) buf, pos);
+    }
+    else{
+        if(swap_cache_enabled){
+            entry->options.dirty = 0;
+        }
+        mmu_disk_read(entry->block, pos);
+    }
+}
+
+//-------------------------- ACCESS ADVICE -----------------------------------------------------------------------
+
+/**
+ * @brief Janela de leitura antecipada das páginas com UVM_ADV_SEQUENTIAL, usada quando a opção readahead oferece uma janela menor.
+ * Uma falha nessas páginas também torna fria a página que ficou essa mesma distância para trás (ver "drop_behind").
+ * 
+ */
+#define ADVICE_SEQUENTIAL_WINDOW 8
+
+/**
+ * @brief Fila circular de quadros frios, oferecidos como vítimas antes dos escolhidos pela política de substituição, protegida por
+ * "frame_lock". "cold_queued" evita que um quadro seja enfileirado duas vezes.
+ * 
+ */
+int* cold_ring;
+unsigned char* cold_queued;
+int cold_head;
+int cold_count;
+
+/**
+ * @brief Torna fria uma página presente na memória principal: seu bit de referência é zerado e seu quadro entra na fila de vítimas
+ * preferenciais. Um acesso observado à página antes de sua retirada a torna novamente comum (ver "page_referenced"). Páginas
+ * fixadas são ignoradas. Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @param entry Entrada da tabela de páginas, cujo processo está adquirido pela thread atual
+ */
+void cold_mark(page_entry* entry){
+    if(entry->options.pinned){
+        return;
+    }
+    entry->options.cold = 1;
+    entry->options.reference_bit = 0;
+    int pos = entry->frame;
+    if(cold_queued[pos] || cold_count == frame.size){
+        return;
+    }
+    cold_queued[pos] = 1;
+    cold_ring[(cold_head + cold_count) % frame.size] = pos;
+    cold_count++;
+    __sync_fetch_and_add(&stats.cold_marked, 1);
+}
+
+/**
+ * @brief Torna fria a página que ficou ADVICE_SEQUENTIAL_WINDOW páginas atrás de uma falha em uma página com UVM_ADV_SEQUENTIAL,
+ * caso ela também tenha essa indicação e esteja presente na memória principal: uma varredura não volta a ela, e seu quadro pode ser
+ * reutilizado antes das páginas dos demais processos.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param index Índice da página que causou a falha
+ */
+void drop_behind(virtual_memory* mem, long index){
+    page_entry* entry = page_table_walk(&mem->page_table, index - ADVICE_SEQUENTIAL_WINDOW, 0);
+    if(entry == NULL || entry->state != PAGE_IN_FRAME || entry->options.prefetched || entry->options.advice != UVM_ADV_SEQUENTIAL){
+        return;
+    }
+    frame_lock_process(mem);
+    cold_mark(entry);
+    pthread_mutex_unlock(&frame_lock);
+}
+
+/**
+ * @brief Retira da fila o primeiro quadro cuja página continua fria. Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @return int O quadro, ou -1 caso não haja nenhum.
+ */
+int cold_pick_victim(void){
+    while(cold_count > 0){
+        int pos = cold_ring[cold_head];
+        cold_head = (cold_head + 1) % frame.size;
+        cold_count--;
+        cold_queued[pos] = 0;
+        if(frame.page_t[pos].entry != NULL && frame.page_t[pos].entry->options.cold){
+            return pos;
+        }
+    }
+    return -1;
+}
+
+//-------------------------- PAGE PINNING ------------------------------------------------------------------------
+
+/**
+ * @brief Verifica se alguma das páginas que mapeiam o quadro está fixada. Deve ser chamada com "frame_lock" adquirido.
+ * 
+ * @param pos Quadro
+ * @return int 1 - Quando o quadro está fixado. 0 - Caso contrário.
+ */
+int frame_pinned(int pos){
+    if(frame.page_t[pos].entry == NULL){
+        return 0;
+    }
+    if(frame_shares[pos].count > 0){
+        for(int i = 0; i < frame_shares[pos].count; i++){
+            if(frame_shares[pos].entries[i]->options.pinned){
+                return 1;
+            }
+        }
+        return 0;
+    }
+    return frame.page_t[pos].entry->options.pinned;
+}
+
+/**
+ * @brief Desfaz a fixação de uma página. Sua permissão continua a mesma, e ela volta a ser candidata à substituição.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param entry Entrada da tabela de páginas
+ */
+void page_unpin(virtual_memory* mem, page_entry* entry){
+    frame_lock_process(mem);
+    if(entry->options.pinned){
+        entry->options.pinned = 0;
+        mem->pinned--;
+        if(entry->options.zero){
+            mem->pinned_zero--;
+        }
+        else{
+            pinned_total--;
+        }
+    }
+    pthread_mutex_unlock(&frame_lock);
+}
+
+//------------------------------------ PAGE REPLACEMENT --------------------------------------------------------
+/**
+ * @brief Limites de quadros livres do daemon de liberação (opções lowmark e highmark). Quando uma falha deixa menos de
+ * "low_watermark" quadros livres, o daemon é acordado e retira páginas até que existam "high_watermark" quadros livres. Abaixo de
+ * "min_watermark" (metade de "low_watermark") a própria falha retira páginas até voltar a ele (ver "reclaim_wakeup").
+ * Com "low_watermark" igual a 0 (padrão) o daemon não é criado, e as páginas são retiradas apenas durante as falhas.
+ * 
+ */
+int low_watermark;
+int high_watermark;
+int min_watermark;
+
+/**
+ * @brief Variável de condição, associada a "frame_lock", utilizada para acordar o daemon.
+ * 
+ */
+pthread_cond_t reclaim_cond;
+/**
+ * @brief Pedidos de liberação feitos por "reclaim_wakeup" e o último pedido atendido por uma volta do daemon, protegidos por
+ * "frame_lock". O daemon só aguarda quando todos os pedidos foram atendidos, de forma que um pedido feito durante uma volta não se
+ * perde.
+ * 
+ */
+unsigned long reclaim_requests;
+unsigned long reclaim_served;
+/**
+ * @brief Último processo cujas páginas o daemon de liberação deixou de examinar por encontrar seu lock ocupado, ou -1. Alterado
+ * com "frame_lock" adquirido.
+ * 
+ */
+pid_t reclaim_busy = -1;
+
+/**
+ * @brief Reserva o bloco do disco das páginas de um quadro antes de sua retirada, quando elas já foram escritas e ainda não têm
+ * bloco (fora do modo OVERCOMMIT_STRICT). As páginas sem bloco de um quadro compartilhado têm o mesmo conteúdo e recebem um único
+ * bloco, também compartilhado (ver "block_shares"). Com os magazines ligados, o bloco vem do magazine da thread, sem adquirir
+ * "block_lock" (ver "magazine_alloc"). Deve ser chamada sem "block_lock".
+ * 
+ * @param pages Páginas que mapeiam o quadro
+ * @param npages Quantidade de páginas
+ * @return int 1 - Quando as páginas podem ser retiradas. 0 - Quando não há bloco livre para elas.
+ */
+int swap_assign(page* pages, int npages){
+    int write_op = 0;
+    int missing = -1;
+    for(int i = 0; i < npages; i++){
+        write_op |= pages[i].entry->options.write_op;
+        if(missing == -1 && pages[i].entry->block == -1){
+            missing = i;
+        }
+    }
+    if(!write_op || missing == -1){
+        return 1;
+    }
+    int pos = magazine_alloc(&block);
+    if(pos != -1){
+        magazine_place(&block, pos, pages[missing]);
+        // O bloco recém-obtido ainda não é visto por outra thread: seus compartilhamentos dispensam "block_lock".
+        for(int i = missing + 1; i < npages; i++){
+            if(pages[i].entry->block == -1){
+                pages[i].entry->block = pos;
+                block_shares[pos]++;
+                block.page_t[pos].entry = NULL;
+            }
+        }
+        return 1;
+    }
+
+    pthread_mutex_lock(&block_lock);
+    pos = page_central_alloc(&block, pages[missing]);
+    if(pos != -1){
+        for(int i = missing + 1; i < npages; i++){
+            if(pages[i].entry->block == -1){
+                pages[i].entry->block = pos;
+                block_shares[pos]++;
+                block.page_t[pos].entry = NULL;
+            }
+        }
+    }
+    pthread_mutex_unlock(&block_lock);
+    return pos != -1;
+}
+
+/**
+ * @brief Verifica se a retirada de um quadro levaria ao disco uma página de um processo que já atingiu seu limite de páginas
+ * guardadas em disco (ver "pager_setlimit"). Páginas nunca escritas voltam ao estado de apenas solicitadas e não contam.
+ * 
+ * @param pages Páginas que mapeiam o quadro
+ * @param mems Memória virtual do processo de cada página, adquirida pela thread atual
+ * @param npages Quantidade de páginas
+ * @return int 1 - Quando o quadro não pode ser retirado. 0 - Caso contrário.
+ */
+int swap_limited(page* pages, virtual_memory** mems, int npages){
+    int write_op = 0;
+    for(int i = 0; i < npages; i++){
+        write_op |= pages[i].entry->options.write_op;
+    }
+    for(int i = 0; write_op && i < npages; i++){
+        unsigned long limit = mems[i]->limits[UVM_LIMIT_SWAP];
+        if(limit != 0 && mems[i]->swapped >= limit){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Retira da memória principal a página que ocupava o quadro "pos". Caso ela não tenha sido escrita, volta ao estado de
+ * apenas solicitada (será preenchida com zeros no próximo acesso); caso contrário é guardada no bloco do disco reservado para ela.
+ * Deve ser chamada com o lock do processo dono da página adquirido e sem "frame_lock".
+ * 
+ * Uma página lida antecipadamente e nunca acessada não está mapeada no processo e é idêntica ao seu bloco, de forma que volta ao
+ * disco sem nenhuma chamada à MMU; a janela de leitura antecipada do processo é reduzida à metade.
+ * 
+ * @param pos Quadro que a página ocupava
+ * @param removed_page Página removida
+ * @param owner Memória virtual do processo dono da página
+ */
+void page_out(int pos, page removed_page, virtual_memory* owner){
+    page_entry* removed_entry = removed_page.entry;
+
+    if(removed_entry->options.prefetched){
+        removed_entry->options.prefetched = 0;
+        removed_entry->options.permission = PROT_READ;
+        removed_entry->state = PAGE_IN_BLOCK;
+        owner->swapped++;
+        if(owner->ra_window > 1){
+            owner->ra_window /= 2;
+        }
+        __sync_fetch_and_add(&stats.evictions, 1);
+        return;
+    }
+
+    mmu_nonresident(removed_page.pid,removed_page.vaddr);
+    removed_entry->options.permission = PROT_READ;
+    __sync_fetch_and_add(&stats.evictions, 1);
+
+    if(removed_entry->options.write_op == 0){
+        removed_entry->state = PAGE_EXTENDED;
+    }
+    else{
+        removed_entry->state = PAGE_IN_BLOCK;
+        owner->swapped++;
+        if(!removed_entry->options.dirty){
+            __sync_fetch_and_add(&stats.swap_cache_hits, 1);
+        }
+        else if(!zswap_store(pos,removed_entry->block)){
+            __sync_fetch_and_add(&stats.writebacks, 1);
+            mmu_disk_write(pos,removed_entry->block);
+        }
+    }
+}
+
+/**
+ * @brief Lote de retiradas de permissão de uma busca por vítima (opção chprotvec=1). Em vez de uma chamada a "mmu_chprot" por quadro
+ * referenciado, as páginas são acumuladas e enviadas ao final da busca com uma chamada a "mmu_chprot_vec" por processo. Os processos
+ * adquiridos durante a busca permanecem adquiridos até o envio, de forma que nenhuma falha deles é tratada antes da retirada.
+ * @param owners Processos adquiridos pela busca (exceto o solicitante)
+ * @param nowners Quantidade de processos adquiridos
+ * @param pids Processo de cada página acumulada
+ * @param vaddrs Endereço virtual de cada página acumulada
+ * @param entries Entrada da tabela de páginas de cada página acumulada
+ * @param count Quantidade de páginas acumuladas
+ * @param capacity Capacidade dos vetores
+ * 
+ */
+typedef struct{
+    virtual_memory** owners;
+    int nowners;
+    pid_t* pids;
+    void** vaddrs;
+    page_entry** entries;
+    int count;
+    int capacity;
+} sweep_batch;
+
+/**
+ * @brief Se 1 (opção chprotvec=1), as buscas por vítima utilizam "sweep_batch".
+ * 
+ */
+int chprot_vec_enabled;
+
+/**
+ * @brief Busca um processo já adquirido pelo lote.
+ * 
+ * @param batch Lote
+ * @param pid Identificador do processo
+ * @return virtual_memory* O processo, ou NULL caso ele não tenha sido adquirido pelo lote.
+ */
+virtual_memory* sweep_batch_owner(sweep_batch* batch, pid_t pid){
+    for(int i = 0; i < batch->nowners; i++){
+        if(batch->owners[i]->pid == pid){
+            return batch->owners[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Acumula a retirada de permissão de uma página no lote.
+ * 
+ * @param batch Lote
+ * @param victim Página
+ */
+void sweep_batch_add(sweep_batch* batch, page victim){
+    if(batch->count == batch->capacity){
+        batch->capacity = batch->capacity ? 2 * batch->capacity : 64;
+        batch->pids = (pid_t*) realloc(batch->pids, sizeof(pid_t) * batch->capacity);
+        batch->vaddrs = (void**) realloc(batch->vaddrs, sizeof(void*) * batch->capacity);
+        batch->entries = (page_entry**) realloc(batch->entries, sizeof(page_entry*) * batch->capacity);
+        batch->owners = (virtual_memory**) realloc(batch->owners, sizeof(virtual_memory*) * batch->capacity);
+    }
+    batch->pids[batch->count] = victim.pid;
+    batch->vaddrs[batch->count] = victim.vaddr;
+    batch->entries[batch->count] = victim.entry;
+    batch->count++;
+}
+
+/**
+ * @brief Envia as retiradas de permissão acumuladas, uma chamada a "mmu_chprot_vec" por processo, e libera os processos adquiridos
+ * pelo lote. Páginas retiradas da memória principal depois de acumuladas são ignoradas. Deve ser chamada sem "frame_lock".
+ * 
+ * @param batch Lote
+ * @param self Processo solicitante, ou NULL
+ */
+void sweep_batch_flush(sweep_batch* batch, virtual_memory* self){
+    void** vaddrs = (void**) malloc(sizeof(void*) * (batch->count + 1));
+    for(int i = -1; i < batch->nowners; i++){
+        virtual_memory* owner = (i == -1) ? self : batch->owners[i];
+        if(owner == NULL){
+            continue;
+        }
+        int n = 0;
+        for(int j = 0; j < batch->count; j++){
+            page_entry* entry = batch->entries[j];
+            if(batch->pids[j] == owner->pid && entry->state == PAGE_IN_FRAME && entry->options.permission == PROT_NONE){
+                vaddrs[n++] = batch->vaddrs[j];
+            }
+        }
+        if(n > 0){
+            mmu_chprot_vec(owner->pid, vaddrs, n, PROT_NONE);
+        }
+    }
+    free(vaddrs);
+    for(int i = 0; i < batch->nowners; i++){
+        vm_unlock(batch->owners[i]);
+    }
+    free(batch->owners);
+    free(batch->pids);
+    free(batch->vaddrs);
+    free(batch->entries);
+}
+
+/**
+ * @brief Adquire, sem espera, os processos que mapeiam um quadro compartilhado candidato à substituição, além do ocupante já
+ * adquirido. O solicitante e os processos já adquiridos pelo lote não precisam ser adquiridos. Deve ser chamada com "frame_lock".
+ * 
+ * @param pos Quadro
+ * @param self Processo solicitante, ou NULL
+ * @param owner Ocupante registrado do quadro, já adquirido
+ * @param held Lote da busca, ou NULL
+ * @param got Vetor com "frame_shares[pos].count" posições que recebe os processos adquiridos, a serem liberados sem "frame_lock"
+ * @param ngot Quantidade de processos adquiridos
+ * @return int 1 caso todos os processos estejam adquiridos, 0 caso algum esteja ocupado.
+ */
+int share_acquire(int pos, virtual_memory* self, virtual_memory* owner, sweep_batch* held, virtual_memory** got, int* ngot){
+    *ngot = 0;
+    for(int i = 0; i < frame_shares[pos].count; i++){
+        virtual_memory* mem = frame_shares[pos].mems[i];
+        int acquired = mem == self || mem == owner || (held != NULL && sweep_batch_owner(held, mem->pid) != NULL);
+        for(int j = 0; j < *ngot && !acquired; j++){
+            acquired = got[j] == mem;
+        }
+        if(acquired){
+            continue;
+        }
+        if(vm_try_acquire(mem->pid) != mem){
+            return 0;
+        }
+        got[(*ngot)++] = mem;
+    }
+    return 1;
+}
+
+/**
+ * @brief Obtém um quadro para a nova página, retirando da memória principal a vítima indicada pela política de substituição.
+ * A cada candidato que possui o bit de referência 1 é dada uma segunda chance: seu bit é colocado como 0, a permissão é retirada
+ * (para que o próximo acesso seja observado) e a política é informada do acesso.
+ * 
+ * Os candidatos são consultados um por vez sob "frame_lock". Páginas de outros processos só são examinadas se o lock do dono puder ser
+ * adquirido sem espera; as chamadas à MMU (retirada de permissão e remoção da vítima) são feitas após liberar "frame_lock", mantendo
+ * apenas o lock do processo dono. O quadro escolhido é entregue à nova página antes disso, de forma que nenhum outro processo o disputa.
+ * 
+ * Um quadro compartilhado após "pager_fork" só é retirado com todos os processos que o mapeiam adquiridos. Depois de uma volta sem
+ * nenhum candidato disponível, o solicitante deixa de mapear os quadros compartilhados com processos ocupados (sua página volta ao
+ * bloco), de forma que duas falhas concorrentes em processos que compartilham todos os quadros não impeçam uma à outra.
+ * 
+ * Na substituição global, os quadros frios (ver "cold_mark") são candidatos antes dos indicados pela política.
+ * Na substituição local ("local" = 1), os candidatos são os quadros do próprio processo, percorridos em seu anel. Na substituição
+ * global com orçamentos ativos, quadros de outros processos dentro do orçamento são poupados durante a primeira volta.
+ * 
+ * Quando chamada pelo daemon de liberação ("new_page" NULL), a função apenas libera o quadro da vítima, retornando -1 caso já existam
+ * "high_watermark" quadros livres ou caso nenhuma vítima possa ser examinada em duas voltas completas.
+ * 
+ * Fora do modo OVERCOMMIT_STRICT, uma vítima já escrita e sem bloco só é retirada se houver um bloco livre para ela (ver
+ * "swap_assign"); caso contrário é ignorada. Se todas as vítimas de duas voltas completas forem ignoradas por esse motivo, falta
+ * espaço de troca e a função retorna -1.
+ * 
+ * @param self Memória virtual do processo que solicita o quadro, adquirida pela thread atual, ou NULL
+ * @param new_page Pagina que irá ocupar o quadro, ou NULL
+ * @param local Se 1, apenas páginas de "self" são candidatas.
+ * @return int - Posicao do quadro obtido, ou -1.
+ */
+int reclaim_frame(virtual_memory* self, page* new_page, int local){
+    int skipped = 0;
+    int unswappable_skips = 0;
+    int pinned_skips = 0;
+    int steps = 0;
+    int result;
+    sweep_batch batch = {0};
+    sweep_batch* held = chprot_vec_enabled ? &batch : NULL;
+    while(1){
+        frame_lock_process(self);
+        if(local && self->resident <= self->pinned - self->pinned_zero){
+            local = 0;
+        }
+        if(!local && new_page != NULL){
+            int pos = frame_alloc(self,*new_page);
+            if(pos != -1){
+                pthread_mutex_unlock(&frame_lock);
+                result = pos;
+                break;
+            }
+        }
+        else if(new_page == NULL && frame.free >= high_watermark){
+            pthread_mutex_unlock(&frame_lock);
+            result = -1;
+            break;
+        }
+
+        int pos = local ? resident_pick_victim(self) : cold_pick_victim();
+        if(!local && pos == -1){
+            // Uma política baseada em filas pode oferecer sempre os mesmos quadros fixados; depois de "frame.size" deles, o
+            // ponteiro do relógio percorre todos os quadros.
+            pos = pinned_skips < frame.size ? policy->pick_victim() : clock_pick_victim();
+        }
+        virtual_memory* owner = NULL;
+        int owner_held = 0;
+        page victim;
+        if(pos != -1 && frame_pinned(pos)){
+            pinned_skips++;
+            __sync_fetch_and_add(&stats.pin_skips, 1);
+        }
+        else if(pos != -1 && frame.page_t[pos].entry != NULL){
+            victim = frame.page_t[pos];
+            if(self != NULL && victim.pid == self->pid){
+                owner = self;
+            }
+            else if(held != NULL && (owner = sweep_batch_owner(held, victim.pid)) != NULL){
+                owner_held = 1;
+            }
+            else{
+                owner = vm_try_acquire(victim.pid);
+                if(owner == NULL && self == NULL){
+                    reclaim_busy = victim.pid;
+                }
+            }
+        }
+        virtual_memory** got = NULL;
+        int ngot = 0;
+        int available = owner != NULL;
+        if(available && frame_shares[pos].count > 0){
+            got = (virtual_memory**) malloc(sizeof(virtual_memory*) * frame_shares[pos].count);
+            available = share_acquire(pos, self, owner, held, got, &ngot);
+        }
+        int detach = -1;
+        page detached;
+        if(!available && owner != NULL && self != NULL && skipped >= frame.size && frame_shares[pos].count > 0){
+            for(int i = 0; i < frame_shares[pos].count && detach == -1; i++){
+                if(frame_shares[pos].mems[i] == self){
+                    detach = i;
+                }
+            }
+        }
+        if(detach != -1){
+            detached.pid = self->pid;
+            detached.vaddr = frame_shares[pos].vaddrs[detach];
+            detached.entry = frame_shares[pos].entries[detach];
+            if(swap_limited(&detached, &self, 1) || !swap_assign(&detached, 1)){
+                detach = -1;
+            }
+        }
+        if(detach != -1){
+            for(int i = 0; i < frame_shares[pos].count; i++){
+                if(frame_shares[pos].entries[i]->block == detached.entry->block){
+                    detached.entry->options.dirty |= frame_shares[pos].entries[i]->options.dirty;
+                }
+            }
+            frame_share_remove(pos, detached.entry);
+            detached.entry->frame = -1;
+        }
+        if(!available){
+            pthread_mutex_unlock(&frame_lock);
+            if(detach != -1){
+                page_out(pos, detached, self);
+            }
+            for(int i = 0; i < ngot; i++){
+                vm_unlock(got[i]);
+            }
+            if(owner != NULL && owner != self && !owner_held){
+                vm_unlock(owner);
+            }
+            free(got);
+            if(++skipped >= 2 * frame.size){
+                if(new_page == NULL){
+                    result = -1;
+                    break;
+                }
+                sched_yield();
+                skipped = unswappable_skips = 0;
+            }
+            continue;
+        }
+
+        page* pages = &victim;
+        virtual_memory** mems = &owner;
+        int npages = 1;
+        if(frame_shares[pos].count > 0){
+            npages = frame_shares[pos].count;
+            pages = (page*) malloc(sizeof(page) * npages);
+            mems = (virtual_memory**) malloc(sizeof(virtual_memory*) * npages);
+            for(int i = 0; i < npages; i++){
+                mems[i] = frame_shares[pos].mems[i];
+                pages[i].pid = mems[i]->pid;
+                pages[i].vaddr = frame_shares[pos].vaddrs[i];
+                pages[i].entry = frame_shares[pos].entries[i];
+            }
+        }
+        int referenced = 0;
+        for(int i = 0; i < npages; i++){
+            referenced |= pages[i].entry->options.reference_bit;
+        }
+
+        int spared = pff_threshold != 0 && owner != self && resident_count(owner) <= owner->budget && ++steps <= frame.size;
+        int evicted = !spared && !referenced;
+        int unswappable = evicted && (swap_limited(pages, mems, npages) || !swap_assign(pages, npages));
+        if(unswappable){
+            evicted = 0;
+        }
+        if(spared || unswappable){
+            pthread_mutex_unlock(&frame_lock);
+        }
+        else if(!evicted){
+            for(int i = 0; i < npages; i++){
+                pages[i].entry->options.permission = PROT_NONE;
+                pages[i].entry->options.reference_bit = 0;
+            }
+            if(policy->on_reference != NULL){
+                policy->on_reference(pos);
+            }
+            pthread_mutex_unlock(&frame_lock);
+            if(held != NULL){
+                for(int i = 0; i < npages; i++){
+                    sweep_batch_add(held, pages[i]);
+                }
+                if(owner != self && !owner_held){
+                    held->owners[held->nowners++] = owner;
+                    owner_held = 1;
+                }
+                for(int i = 0; i < ngot; i++){
+                    held->owners[held->nowners++] = got[i];
+                }
+                ngot = 0;
+            }
+            else{
+                for(int i = 0; i < npages; i++){
+                    mmu_chprot(pages[i].pid,pages[i].vaddr,PROT_NONE);
+                }
+            }
+        }
+        else{
+            if(policy->on_free != NULL){
+                policy->on_free(pos, 1);
+            }
+            if(npages > 1){
+                // Cada bloco é escrito uma única vez: páginas copiadas por "pager_fork" compartilham o bloco, enquanto páginas
+                // unidas pela deduplicação têm blocos próprios.
+                int write_op = 0;
+                for(int i = 0; i < npages; i++){
+                    write_op |= pages[i].entry->options.write_op;
+                }
+                for(int i = 0; i < npages; i++){
+                    pages[i].entry->options.write_op = write_op;
+                    int first = 1;
+                    for(int j = 0; j < i && first; j++){
+                        first = pages[j].entry->block != pages[i].entry->block;
+                    }
+                    if(!first){
+                        continue;
+                    }
+                    int dirty = 0;
+                    for(int j = i; j < npages; j++){
+                        if(pages[j].entry->block == pages[i].entry->block){
+                            dirty |= pages[j].entry->options.dirty;
+                            pages[j].entry->options.dirty = 0;
+                        }
+                    }
+                    pages[i].entry->options.dirty = dirty;
+                }
+                frame_share_clear(pos);
+            }
+            clean_page(&frame,pos);
+            resident_unlink(owner,pos);
+            if(new_page != NULL){
+                place_page(&frame,pos,*new_page);
+                resident_link(self,pos);
+                if(policy->on_fault != NULL){
+                    policy->on_fault(pos);
+                }
+                __sync_fetch_and_add(&stats.direct_reclaims, 1);
+            }
+            pthread_mutex_unlock(&frame_lock);
+            for(int i = 0; i < npages; i++){
+                page_out(pos,pages[i],mems[i]);
+            }
+            if(new_page == NULL){
+                pthread_mutex_lock(&frame_lock);
+                page_central_release(&frame,pos);
+                pthread_mutex_unlock(&frame_lock);
+            }
+        }
+
+        for(int i = 0; i < ngot; i++){
+            vm_unlock(got[i]);
+        }
+        if(owner != self && !owner_held){
+            vm_unlock(owner);
+        }
+        free(got);
+        if(npages > 1){
+            free(pages);
+            free(mems);
+        }
+        if(evicted){
+            result = pos;
+            break;
+        }
+        if(unswappable){
+            unswappable_skips++;
+            if(++skipped >= 2 * frame.size){
+                if(new_page == NULL || unswappable_skips == skipped){
+                    result = -1;
+                    break;
+                }
+                sched_yield();
+                skipped = unswappable_skips = 0;
+            }
+        }
+    }
+    if(held != NULL){
+        sweep_batch_flush(held, self);
+    }
+    return result;
+}
+
+/**
+ * @brief Informa a política de substituição de um acesso observado a uma página presente na memória principal. A página deixa
+ * de ser fria.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param entry Entrada da tabela de páginas
+ */
+void page_referenced(virtual_memory* mem, page_entry* entry){
+    entry->options.cold = 0;
+    if(policy->on_reference == NULL){
+        return;
+    }
+    frame_lock_process(mem);
+    policy->on_reference(entry->frame);
+    pthread_mutex_unlock(&frame_lock);
+}
+
+/**
+ * @brief Obtém um quadro para a página: um quadro livre (com os magazines ligados, retirado sem "frame_lock" do magazine da thread,
+ * ver "frame_defer") ou, se não houver (ou se o processo já ocupar todo o seu orçamento ou atingir seu limite de quadros), o quadro obtido por "reclaim_frame". Um processo no limite de quadros só substitui suas próprias
+ * páginas: caso nenhuma possa ser retirada, a falha não é atendida.
+ * 
+ * @param mem Memória virtual do processo dono da página, adquirida pela thread atual
+ * @param new_page Página que ocupará o quadro
+ * @return int O quadro obtido, ou -1 caso falte espaço de troca para retirar qualquer vítima (fora do modo OVERCOMMIT_STRICT ou
+ * no limite de páginas em disco do processo).
+ */
+int page_frame_get(virtual_memory* mem, page new_page){
+    int alloc_pos = -1;
+    int local = pff_update(mem);
+    int limited = resident_limited(mem);
+    if(local || limited){
+        alloc_pos = reclaim_frame(mem,&new_page,1);
+    }
+    else{
+        alloc_pos = magazine_get(&frame);
+        if(alloc_pos != -1){
+            __sync_fetch_and_add(&stats.magazine_hits, 1);
+            frame_defer(mem, alloc_pos, new_page);
+        }
+        else{
+            frame_lock_process(mem);
+            if(magazine_size != 0){
+                __sync_fetch_and_add(&stats.table_locks, 1);
+            }
+            alloc_pos = magazine_page_alloc(&frame, new_page);
+            if(alloc_pos != -1){
+                frame_attach(mem, alloc_pos);
+            }
+            pthread_mutex_unlock(&frame_lock);
+        }
+    }
+    if(alloc_pos == -1 && !limited){
+        alloc_pos = reclaim_frame(mem,&new_page,0);
+    }
+    return alloc_pos;
+}
+
+/**
+ * @brief Lê antecipadamente do disco uma página guardada em disco (PAGE_IN_BLOCK). Ela ocupa um quadro, mas só é mapeada no processo
+ * quando acessada (ver "readahead_hit").
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param index Índice da página
+ * @param entry Entrada da tabela de páginas
+ * @return int 0 - Quando a página foi lida. -1 - Quando falta espaço de troca para obter um quadro.
+ */
+int prefetch_page(virtual_memory* mem, long index, page_entry* entry){
+    page new_page;
+    new_page.pid = mem->pid;
+    new_page.vaddr = INDEX_TO_VIRTUAL_ADDR(index);
+    new_page.entry = entry;
+
+    entry->options.permission = PROT_NONE;
+    entry->options.reference_bit = 0;
+    entry->options.prefetched = 1;
+    entry->options.cold = 0;
+    int pos = page_frame_get(mem, new_page);
+    if(pos == -1){
+        entry->options.prefetched = 0;
+        return -1;
+    }
+    entry->state = PAGE_IN_FRAME;
+    mem->swapped--;
+    __sync_fetch_and_add(&stats.prefetched, 1);
+    swap_read(entry, pos);
+    return 0;
+}
+
+/**
+ * @brief Lê antecipadamente do disco as páginas seguintes a uma falha sequencial do processo (opção readahead=N). São lidas as
+ * páginas guardadas em disco entre as "ra_window" seguintes; elas ocupam quadros, mas só são mapeadas no processo quando acessadas.
+ * Cada página lida antecipadamente que é acessada aumenta a janela em 1, até N; cada uma retirada sem ter sido acessada a reduz à
+ * metade (ver "page_out").
+ * 
+ * Páginas com UVM_ADV_SEQUENTIAL ("sequential" = 1) são lidas antecipadamente em toda falha, com janela de ao menos
+ * ADVICE_SEQUENTIAL_WINDOW páginas.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param index Índice da página que causou a falha
+ * @param sequential Se 1, a falha é considerada sequencial.
+ */
+void readahead(virtual_memory* mem, long index, int sequential){
+    if(!sequential && index != mem->ra_next){
+        mem->ra_next = index + 1;
+        return;
+    }
+
+    int window = mem->ra_window;
+    if(sequential && window < ADVICE_SEQUENTIAL_WINDOW){
+        window = ADVICE_SEQUENTIAL_WINDOW;
+    }
+    long last = index + window;
+    for(long next = index + 1; next <= last; next++){
+        page_entry* entry = page_table_walk(&mem->page_table, next, 0);
+        if(entry != NULL && entry->state == PAGE_IN_BLOCK && prefetch_page(mem, next, entry) == -1){
+            break;
+        }
+    }
+    mem->ra_next = last + 1;
+}
+
+/**
+ * @brief Mapeia no processo uma página lida antecipadamente, em seu primeiro acesso, aumentando a janela de leitura antecipada.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param vaddr Endereço virtual inicial da página
+ * @param entry Entrada da tabela de páginas
+ */
+void readahead_hit(virtual_memory* mem, void* vaddr, page_entry* entry){
+    entry->options.prefetched = 0;
+    entry->options.permission = PROT_READ;
+    entry->options.reference_bit = 1;
+    if(mem->ra_window < readahead_max){
+        mem->ra_window++;
+    }
+    __sync_fetch_and_add(&stats.prefetch_hits, 1);
+    page_referenced(mem, entry);
+    mmu_resident(mem->pid, vaddr, entry->frame, PROT_READ);
+}
+
+/**
+ * @brief Falha em torno (opção faultaround=K): devolve a permissão de leitura às páginas do processo presentes na memória principal,
+ * mas sem permissão após uma volta do relógio, no bloco alinhado de K páginas que contém a falha. Assim uma varredura sobre dados
+ * presentes causa uma falha a cada K páginas. As páginas são restauradas como não referenciadas, de forma que continuam candidatas
+ * à substituição caso não sejam acessadas. As permissões são enviadas à MMU em uma única chamada a "mmu_chprot_vec".
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param index Índice da página que causou a falha
+ */
+void fault_around(virtual_memory* mem, long index){
+    long first = index - index % faultaround_pages;
+    void* vaddrs[FAULTAROUND_MAX];
+    int count = 0;
+    for(long next = first; next < first + faultaround_pages; next++){
+        if(next == index){
+            continue;
+        }
+        page_entry* entry = page_table_walk(&mem->page_table, next, 0);
+        if(entry == NULL || entry->state != PAGE_IN_FRAME || entry->options.prefetched || entry->options.permission != PROT_NONE){
+            continue;
+        }
+        entry->options.permission = PROT_READ;
+        __sync_fetch_and_add(&stats.faultaround, 1);
+        vaddrs[count++] = INDEX_TO_VIRTUAL_ADDR(next);
+    }
+    if(count > 0){
+        mmu_chprot_vec(mem->pid, vaddrs, count, PROT_READ);
+    }
+}
+
+/**
+ * @brief Traz para a memória principal uma página que ainda não está nela, seja ela nova (preenchida com zeros) ou
+ * guardada em disco, ocupando um quadro livre ou, se não houver, o quadro obtido por "reclaim_frame".
+ * A página fica com permissão de leitura e bit de referência igual a 1. Páginas trazidas do disco podem iniciar a leitura
+ * antecipada das seguintes (ver "readahead"), exceto com UVM_ADV_RANDOM; com UVM_ADV_SEQUENTIAL, a página que ficou para trás
+ * torna-se fria (ver "drop_behind").
+ * 
+ * @param mem Memória virtual do processo dono da página, adquirida pela thread atual
+ * @param vaddr Endereço virtual inicial da página
+ * @param entry Entrada da tabela de páginas do processo
+ * @return int 0 - Quando a página foi trazida. -1 - Quando falta espaço de troca para obter um quadro (ver "reclaim_frame").
+ */
+int page_in(virtual_memory* mem, void* vaddr, page_entry* entry){
+    page new_page;
+    new_page.pid = mem->pid;
+    new_page.vaddr = vaddr;
+    new_page.entry = entry;
+
+    int from_block = entry->state == PAGE_IN_BLOCK;
+    if(!from_block){
+        entry->options.write_op = 0;
+        entry->options.dirty = 0;
+    }
+    entry->options.permission = PROT_READ;
+    entry->options.reference_bit = 1;
+    entry->options.cold = 0;
+
+    // A página deixa de contar no limite de páginas em disco antes da busca por um quadro, de forma que um processo no limite
+    // pode trocar uma página do disco por uma de seus quadros.
+    if(from_block){
+        mem->swapped--;
+    }
+    int alloc_pos = page_frame_get(mem, new_page);
+    if(alloc_pos == -1){
+        if(from_block){
+            mem->swapped++;
+        }
+        __sync_fetch_and_add(&stats.swap_failures, 1);
+        return -1;
+    }
+
+    entry->state = PAGE_IN_FRAME;
+    if(from_block){
+        __sync_fetch_and_add(&stats.major_faults, 1);
+        swap_read(entry,alloc_pos);
+    }
+    else{
+        __sync_fetch_and_add(&stats.zero_fills, 1);
+        mmu_zero_fill(alloc_pos);
+    }
+    mmu_resident(mem->pid,vaddr,alloc_pos,PROT_READ);
+
+    int sequential = entry->options.advice == UVM_ADV_SEQUENTIAL;
+    if(from_block && entry->options.advice != UVM_ADV_RANDOM && (readahead_max > 0 || sequential)){
+        readahead(mem, VIRTUAL_ADDR_TO_INDEX(vaddr), sequential);
+    }
+    if(sequential){
+        drop_behind(mem, VIRTUAL_ADDR_TO_INDEX(vaddr));
+    }
+    return 0;
+}
+
+/**
+ * @brief Primeira escrita em uma página com "cow": antes de receber permissão de escrita, a página passa a ter um quadro e um
+ * bloco exclusivos. Se o quadro estiver compartilhado, um novo quadro recebe uma cópia dele (ou, caso a própria busca por um
+ * quadro tenha retirado o compartilhado da memória principal, o conteúdo do bloco); se o bloco estiver compartilhado, um bloco
+ * livre da reserva "cow_reserve" passa a ser o da página (fora do modo OVERCOMMIT_STRICT, a página apenas deixa o bloco e recebe
+ * outro em sua retirada). Os demais processos continuam com o quadro e o bloco originais.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param vaddr Endereço virtual inicial da página
+ * @param entry Entrada da tabela de páginas, presente na memória principal com permissão de leitura
+ * @return int 0 - Quando a página recebeu permissão de escrita. -1 - Quando falta espaço de troca para obter um quadro.
+ */
+int cow_break(virtual_memory* mem, void* vaddr, page_entry* entry){
+    int shared_frame = entry->frame;
+    frame_lock_process(mem);
+    int shared = frame_shares[shared_frame].count > 0;
+    pthread_mutex_unlock(&frame_lock);
+
+    if(shared){
+        page new_page;
+        new_page.pid = mem->pid;
+        new_page.vaddr = vaddr;
+        new_page.entry = entry;
+        int pos = page_frame_get(mem, new_page);
+        if(pos == -1){
+            __sync_fetch_and_add(&stats.swap_failures, 1);
+            return -1;
+        }
+
+        if(entry->state == PAGE_IN_FRAME){
+            mmu_copy_frame(shared_frame, pos);
+            frame_lock_process(mem);
+            if(frame_share_find(shared_frame, entry) != -1){
+                frame_share_remove(shared_frame, entry);
+            }
+            else{
+                // Os demais processos deixaram o quadro durante a busca, que passou a ser apenas desta página.
+                if(policy->on_free != NULL){
+                    policy->on_free(shared_frame, 0);
+                }
+                resident_unlink(mem, shared_frame);
+                page_central_release(&frame, shared_frame);
+                entry->frame = pos;
+            }
+            pthread_mutex_unlock(&frame_lock);
+        }
+        else if(entry->state == PAGE_IN_BLOCK){
+            swap_read(entry, pos);
+            mem->swapped--;
+        }
+        else{
+            mmu_zero_fill(pos);
+        }
+        entry->state = PAGE_IN_FRAME;
+        __sync_fetch_and_add(&stats.cow_copies, 1);
+    }
+
+    pthread_mutex_lock(&block_lock);
+    if(entry->block != -1 && block_shares[entry->block] > 0){
+        block_shares[entry->block]--;
+        if(overcommit_mode == OVERCOMMIT_STRICT){
+            cow_reserve--;
+            page private_page;
+            private_page.pid = mem->pid;
+            private_page.vaddr = vaddr;
+            private_page.entry = entry;
+            magazine_page_alloc(&block, private_page);
+        }
+        else{
+            entry->block = -1;
+        }
+    }
+    pthread_mutex_unlock(&block_lock);
+
+    entry->options.cow = 0;
+    entry->options.write_op = 1;
+    entry->options.dirty = 1;
+    entry->options.permission = PROT_WRITE | PROT_READ;
+    entry->options.reference_bit = 1;
+    if(shared){
+        mmu_resident(mem->pid, vaddr, entry->frame, entry->options.permission);
+    }
+    else{
+        page_referenced(mem, entry);
+        mmu_chprot(mem->pid, vaddr, entry->options.permission);
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Primeira escrita em uma página mapeada no quadro de zeros: a página passa a ocupar um quadro próprio, preenchido com zeros
+ * por "page_in", e recebe permissão de escrita (passando por "cow_break" caso seu bloco esteja compartilhado). Uma página fixada
+ * passa a contar em "pinned_total", e a escrita falha caso metade dos quadros já esteja fixada.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param vaddr Endereço virtual inicial da página
+ * @param entry Entrada da tabela de páginas, mapeada no quadro de zeros
+ * @return int 0 - Quando a página recebeu permissão de escrita. -1 - Quando falta espaço de troca para obter um quadro ou, para uma
+ * página fixada, quando não há quadros fixáveis.
+ */
+int zero_write(virtual_memory* mem, void* vaddr, page_entry* entry){
+    if(entry->options.pinned){
+        frame_lock_process(mem);
+        int allowed = pinned_total < frame.size / 2;
+        if(allowed){
+            pinned_total++;
+            mem->pinned_zero--;
+        }
+        pthread_mutex_unlock(&frame_lock);
+        if(!allowed){
+            return -1;
+        }
+    }
+    entry->options.zero = 0;
+    if(page_in(mem, vaddr, entry) == -1){
+        entry->options.zero = 1;
+        if(entry->options.pinned){
+            frame_lock_process(mem);
+            pinned_total--;
+            mem->pinned_zero++;
+            pthread_mutex_unlock(&frame_lock);
+        }
+        return -1;
+    }
+    if(entry->options.cow){
+        return cow_break(mem, vaddr, entry);
+    }
+    entry->options.write_op = 1;
+    entry->options.dirty = 1;
+    entry->options.permission = PROT_WRITE | PROT_READ;
+    mmu_chprot(mem->pid, vaddr, entry->options.permission);
+    return 0;
+}
+
+
+//-------------------------- RECLAIM DAEMON ----------------------------------------------------------------------------
+
+/**
+ * @brief Laço do daemon de liberação. Nenhum lock de processo é mantido entre as retiradas, de forma que as falhas de página
+ * concorrentes só aguardam o daemon pelo tempo de uma retirada de um de seus próprios quadros. Ao fim de cada volta, o limite
+ * inferior é verificado novamente, e uma nova volta é feita enquanto faltarem quadros livres e a volta anterior tiver liberado
+ * algum. Os pedidos feitos durante uma volta são atendidos pela seguinte. Os donos ocupados são ignorados durante a volta; se ela
+ * terminar abaixo do limite inferior, o daemon aguarda o lock do último dono ignorado ("reclaim_busy"), sem manter nenhum outro
+ * lock, e retira um de seus quadros assim que a falha que o detinha o libera, antes de tentar uma nova volta.
+ * 
+ * @param arg Não utilizado
+ * @return void* Nunca retorna
+ */
+void* reclaim_daemon(void* arg){
+    pthread_mutex_lock(&frame_lock);
+    while(1){
+        while(reclaim_served == reclaim_requests){
+            pthread_cond_wait(&reclaim_cond, &frame_lock);
+        }
+        reclaim_served = reclaim_requests;
+        int before = frame.size;
+        while(frame.free < low_watermark && frame.free < before){
+            before = frame.free;
+            reclaim_busy = -1;
+            pthread_mutex_unlock(&frame_lock);
+            while(reclaim_frame(NULL, NULL, 0) != -1);
+            pthread_mutex_lock(&frame_lock);
+            if(frame.free < low_watermark && reclaim_busy != -1){
+                pid_t pid = reclaim_busy;
+                pthread_mutex_unlock(&frame_lock);
+                virtual_memory* mem = vm_acquire(pid);
+                if(mem != NULL){
+                    reclaim_frame(mem, NULL, 0);
+                    vm_unlock(mem);
+                }
+                pthread_mutex_lock(&frame_lock);
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Pede ao daemon de liberação uma volta de retiradas caso existam menos de "low_watermark" quadros livres, sem aguardá-la.
+ * É chamada por "pager_fault" depois de liberar o processo, que assim pode ter suas páginas retiradas pelo daemon. Apenas quando
+ * restam menos de "min_watermark" quadros livres a falha retira páginas por conta própria, até voltar a esse limite, de forma que
+ * o daemon não fique para trás das falhas.
+ * 
+ */
+void reclaim_wakeup(){
+    if(low_watermark == 0){
+        return;
+    }
+    pthread_mutex_lock(&frame_lock);
+    if(frame.free < low_watermark){
+        reclaim_requests++;
+        pthread_cond_signal(&reclaim_cond);
+    }
+    pthread_mutex_unlock(&frame_lock);
+    while(frame.free < min_watermark && reclaim_frame(NULL, NULL, 0) != -1){
+        __sync_fetch_and_add(&stats.direct_reclaims, 1);
+    }
+}
+
+/**
+ * @brief Acorda o daemon de escrita caso existam quadros enfileirados. Assim como "reclaim_wakeup", é chamada por "pager_fault"
+ * depois de liberar o processo, cujos quadros o daemon não consegue adquirir durante a falha que os enfileirou.
+ * 
+ */
+void writeback_wakeup(){
+    if(!writeback_enabled){
+        return;
+    }
+    pthread_mutex_lock(&frame_lock);
+    if(wb_count > 0){
+        wb_wakeups++;
+        pthread_cond_signal(&writeback_cond);
+    }
+    pthread_mutex_unlock(&frame_lock);
+}
+
+/**
+ * @brief Laço do daemon de escrita em segundo plano. Para cada quadro enfileirado que continua sujo e não referenciado, retira a
+ * permissão de escrita da página (de forma que uma nova escrita volte a marcá-la como suja) e copia o quadro para o bloco reservado
+ * (reservado nesse momento, se ainda não houver, fora do modo OVERCOMMIT_STRICT), com apenas o lock do processo dono adquirido. Assim, a retirada da página não precisa mais escrevê-la no disco.
+ * 
+ * Quadros compartilhados (ver "frame_shares") são ignorados e escritos apenas em sua retirada. A fila é percorrida em voltas,
+ * cada uma com os quadros enfileirados até seu início. Um quadro cujo dono está ocupado volta ao fim da fila e o daemon segue com
+ * os demais; apenas quando todos os quadros de uma volta foram adiados ele aguarda o fim de alguma falha (ver "writeback_wakeup").
+ * 
+ * @param arg Não utilizado
+ * @return void* Nunca retorna
+ */
+void* writeback_daemon(void* arg){
+    pthread_mutex_lock(&frame_lock);
+    while(1){
+        while(wb_count == 0){
+            pthread_cond_wait(&writeback_cond, &frame_lock);
+        }
+        unsigned long seen = wb_wakeups;
+        int pass = wb_count;
+        int deferred = 0;
+        for(int i = 0; i < pass; i++){
+            int pos = wb_ring[wb_head];
+            wb_head = (wb_head + 1) % frame.size;
+            wb_count--;
+            wb_queued[pos] = 0;
+
+            page dirty_page = frame.page_t[pos];
+            // Os bits de um quadro compartilhado estão espalhados pelas entradas de todos os processos que o mapeiam, e cada bloco
+            // só pode ser escrito com todos eles adquiridos: o quadro fica para a retirada (ver "reclaim_frame").
+            if(dirty_page.entry == NULL || frame_shares[pos].count > 0){
+                continue;
+            }
+            virtual_memory* owner = vm_try_acquire(dirty_page.pid);
+            if(owner == NULL){
+                // O dono está ocupado, em geral com a própria falha que enfileirou o quadro: ele volta para o fim da fila.
+                writeback_enqueue(pos);
+                deferred++;
+                continue;
+            }
+            pthread_mutex_unlock(&frame_lock);
+
+            page_entry* entry = dirty_page.entry;
+            if(entry->options.dirty && !entry->options.reference_bit && !entry->options.pinned && swap_assign(&dirty_page, 1)){
+                if(entry->options.permission & PROT_WRITE){
+                    entry->options.permission = PROT_READ;
+                    mmu_chprot(dirty_page.pid, dirty_page.vaddr, PROT_READ);
+                }
+                mmu_disk_write(pos, entry->block);
+                if(zswap_pages > 0){
+                    pthread_mutex_lock(&block_lock);
+                    zswap_drop(entry->block);
+                    pthread_mutex_unlock(&block_lock);
+                }
+                entry->options.dirty = 0;
+                __sync_fetch_and_add(&stats.cleaned, 1);
+            }
+            vm_unlock(owner);
+
+            pthread_mutex_lock(&frame_lock);
+        }
+        if(deferred == pass){
+            while(wb_wakeups == seen){
+                pthread_cond_wait(&writeback_cond, &frame_lock);
+            }
+        }
+    }
+    return NULL;
+}
+
+//-------------------------- DEDUPLICATION -----------------------------------------------------------------------------
+
+/**
+ * @brief Intervalo, em milissegundos, entre as varreduras do daemon de deduplicação (opção dedup=MS). Desligado (0) por padrão.
+ * 
+ */
+int dedup_interval;
+
+/**
+ * @brief Calcula o hash FNV-1a do conteúdo de um quadro em "pmem", uma palavra de 64 bits por vez.
+ * 
+ * @param pos Quadro
+ * @return uint64_t Hash do conteúdo
+ */
+uint64_t frame_hash(int pos){
+    const uint64_t* words = (const uint64_t*) (pmem + pos * PAGE_SIZE);
+    long nwords = PAGE_SIZE / sizeof(uint64_t);
+    uint64_t hash = 14695981039346656037ULL;
+    for(long i = 0; i < nwords; i++){
+        hash = (hash ^ words[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Verifica se o quadro pode ser unido a outro de mesmo conteúdo: ele deve conter uma página já escrita e que não possa ser
+ * escrita sem uma falha (sem permissão de escrita, ou compartilhada, cujas páginas são todas somente leitura). Deve ser chamada com
+ * "frame_lock" adquirido; a leitura das entradas sem o lock de seus processos é confirmada por "dedup_merge".
+ * 
+ * @param pos Quadro
+ * @return int 1 - Quando o quadro é candidato. 0 - Caso contrário.
+ */
+int dedup_candidate(int pos){
+    page_entry* entry = frame.page_t[pos].entry;
+    if(entry == NULL || entry->options.prefetched || frame_pinned(pos)){
+        return 0;
+    }
+    if(frame_shares[pos].count > 0){
+        for(int i = 0; i < frame_shares[pos].count; i++){
+            if(!frame_shares[pos].entries[i]->options.write_op){
+                return 0;
+            }
+        }
+        return 1;
+    }
+    return entry->options.write_op && !(entry->options.permission & PROT_WRITE);
+}
+
+/**
+ * @brief Une a página do quadro "pos" ao quadro "target", de mesmo hash: se os conteúdos forem iguais, a página passa a mapear
+ * "target" em cópia na escrita (ver "frame_shares"), mantendo seu próprio bloco, e "pos" é liberado. Uma escrita posterior em
+ * qualquer uma das páginas volta a separá-las (ver "cow_break").
+ * 
+ * Apenas quadros não compartilhados são unidos a outros, e os processos envolvidos são adquiridos sem espera; quando algum está
+ * ocupado, nada é feito.
+ * 
+ * @param pos Quadro a ser liberado
+ * @param target Quadro que passará a ser compartilhado
+ * @return int O quadro mantido (que pode ser "pos", caso apenas ele já estivesse compartilhado), ou -1 quando nada foi unido.
+ */
+int dedup_merge(int pos, int target){
+    pthread_mutex_lock(&frame_lock);
+    if(frame_shares[pos].count > 0){
+        int swap = pos;
+        pos = target;
+        target = swap;
+    }
+    page victim = frame.page_t[pos];
+    page kept = frame.page_t[target];
+    if(!dedup_candidate(pos) || !dedup_candidate(target) || frame_shares[pos].count > 0){
+        pthread_mutex_unlock(&frame_lock);
+        return -1;
+    }
+    virtual_memory* owner = vm_try_acquire(victim.pid);
+    virtual_memory* kept_owner = NULL;
+    if(owner != NULL && frame_shares[target].count == 0){
+        kept_owner = (kept.pid == victim.pid) ? owner : vm_try_acquire(kept.pid);
+    }
+    int merge = owner != NULL && (kept_owner != NULL || frame_shares[target].count > 0) &&
+        memcmp(pmem + pos * PAGE_SIZE, pmem + target * PAGE_SIZE, PAGE_SIZE) == 0;
+    if(merge){
+        if(frame_shares[target].count == 0){
+            frame_share_add(target, kept_owner, kept.entry, kept.vaddr);
+            kept.entry->options.cow = 1;
+        }
+        frame_share_add(target, owner, victim.entry, victim.vaddr);
+        if(policy->on_free != NULL){
+            policy->on_free(pos, 0);
+        }
+        resident_unlink(owner, pos);
+        clean_page(&frame, pos);
+        victim.entry->frame = target;
+        victim.entry->options.cow = 1;
+        victim.entry->options.permission = PROT_READ;
+    }
+    pthread_mutex_unlock(&frame_lock);
+
+    if(merge){
+        mmu_resident(victim.pid, victim.vaddr, target, PROT_READ);
+        pthread_mutex_lock(&frame_lock);
+        page_central_release(&frame, pos);
+        pthread_mutex_unlock(&frame_lock);
+        __sync_fetch_and_add(&stats.dedup_merged, 1);
+    }
+    if(kept_owner != NULL && kept_owner != owner){
+        vm_unlock(kept_owner);
+    }
+    if(owner != NULL){
+        vm_unlock(owner);
+    }
+    return merge ? target : -1;
+}
+
+/**
+ * @brief Laço do daemon de deduplicação (opção dedup=MS). A cada intervalo, calcula o hash de cada quadro candidato e o procura em
+ * uma tabela de endereçamento aberto com os quadros já examinados na varredura; quadros de mesmo hash são unidos por "dedup_merge".
+ * O quadro liberado fica sem ocupante até ser devolvido ao mapa de bits, depois que a página passa a mapear o quadro mantido.
+ * 
+ * @param arg Não utilizado
+ * @return void* Nunca retorna
+ */
+void* dedup_daemon(void* arg){
+    int size = 2 * frame.size;
+    uint64_t* hashes = (uint64_t*) malloc(sizeof(uint64_t) * size);
+    int* slots = (int*) malloc(sizeof(int) * size);
+    while(1){
+        usleep(dedup_interval * 1000);
+        for(int i = 0; i < size; i++){
+            slots[i] = -1;
+        }
+        for(int pos = 0; pos < frame.size; pos++){
+            pthread_mutex_lock(&frame_lock);
+            int candidate = dedup_candidate(pos);
+            pthread_mutex_unlock(&frame_lock);
+            if(!candidate){
+                continue;
+            }
+            uint64_t hash = frame_hash(pos);
+            __sync_fetch_and_add(&stats.dedup_scanned, 1);
+            int slot = hash % size;
+            while(slots[slot] != -1 && hashes[slot] != hash){
+                slot = (slot + 1) % size;
+            }
+            if(slots[slot] == -1){
+                slots[slot] = pos;
+                hashes[slot] = hash;
+            }
+            else{
+                int kept = dedup_merge(pos, slots[slot]);
+                if(kept != -1){
+                    slots[slot] = kept;
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+//-------------------------- PAGER CORE --------------------------------------------------------------------------------
+
+/**
+ * @brief Converte o valor de uma opção numérica, que deve ser um número decimal não negativo sem caracteres adicionais.
+ * 
+ * @param value Valor da opção
+ * @param max Maior valor aceito
+ * @param number Número convertido
+ * @return int 0 - Quando o valor é válido. -1 - Caso contrário.
+ */
+int option_number(const char* value, unsigned long max, unsigned long* number){
+    char* end;
+    if(*value < '0' || *value > '9'){
+        return -1;
+    }
+    errno = 0;
+    *number = strtoul(value, &end, 10);
+    return *end == '\0' && errno == 0 && *number <= max ? 0 : -1;
+}
+
+/**
+ * @brief Converte o valor de uma opção numérica (ver "option_number") para uma variável int.
+ * 
+ * @param value Valor da opção
+ * @param target Variável da opção, alterada apenas quando o valor é válido
+ * @return int 0 - Quando o valor é válido. -1 - Caso contrário.
+ */
+int option_int(const char* value, int* target){
+    unsigned long number;
+    if(option_number(value, INT_MAX, &number) != 0){
+        return -1;
+    }
+    *target = (int) number;
+    return 0;
+}
+
+/**
+ * @brief Converte o valor de uma opção de liga/desliga, que deve ser 0 ou 1, para uma variável int.
+ * 
+ * @param value Valor da opção
+ * @param target Variável da opção, alterada apenas quando o valor é válido
+ * @return int 0 - Quando o valor é válido. -1 - Caso contrário.
+ */
+int option_bool(const char* value, int* target){
+    unsigned long number;
+    if(option_number(value, 1, &number) != 0){
+        return -1;
+    }
+    *target = (int) number;
+    return 0;
+}
+
+/**
+ * @brief Define uma opção do paginador, recebida na linha de comando do "bin/mmu" no formato CHAVE=VALOR. Deve ser chamada antes
+ * de "pager_init". Os valores numéricos são decimais não negativos (ver "option_number"), e as opções de liga/desliga aceitam
+ * apenas 0 ou 1 (ver "option_bool"). Opções reconhecidas:
+ * policy - Política de substituição de páginas: clock (padrão), lru, clockpro, 2q, arc ou nru.
+ * lowmark, highmark - Limites de quadros livres do daemon de liberação (ver "low_watermark"). Desligado por padrão.
+ * pff - Limiar do algoritmo PFF, que define orçamentos de quadros por processo (ver "pff_threshold"). Desligado por padrão.
+ * readahead - Tamanho máximo da janela de leitura antecipada de páginas guardadas em disco. Desligado por padrão.
+ * faultaround - Quantidade de páginas do bloco considerado pela falha em torno, até FAULTAROUND_MAX. Desligado por padrão.
+ * writeback - Se 1, páginas sujas encontradas pela política nru são escritas no disco em segundo plano.
+ * dedup - Intervalo, em milissegundos, entre as varreduras da deduplicação de quadros de mesmo conteúdo. Desligado por padrão.
+ * zswap - Capacidade, em páginas, da área de troca comprimida em memória, usada antes dos blocos do disco. Desligada por padrão.
+ * overcommit - Modo de compromisso de blocos: strict (padrão), ratio ou unlimited (ver "overcommit_mode").
+ * commitratio - Porcentagem dos quadros somada aos blocos no limite do modo ratio. 100 por padrão.
+ * swapcache - Se 1, páginas lidas do disco ficam limpas até a primeira escrita, e sua retirada dispensa a escrita no disco.
+ * zeropage - Se 1, o primeiro acesso de leitura a uma página nova mapeia um quadro de zeros compartilhado.
+ * pinlimit - Quantidade máxima de páginas fixadas por processo (ver "pin_limit"). 1/4 dos quadros por padrão.
+ * maxresident, maxswap, maxpages - Limites de quadros, de páginas em disco e de páginas solicitadas com que cada processo é criado
+ * (ver "pager_setlimit"). Sem limite por padrão.
+ * magazine - Quantidade de quadros e blocos livres que cada thread guarda para si (ver "page_magazine"). Desligado por padrão.
+ * stats - Se 1, imprime os contadores do paginador sempre que o último processo é destruído.
+ * 
+ * @param key Nome da opção
+ * @param value Valor da opção
+ * @return int 0 - Quando a opção foi aceita. -1 - Quando a opção ou o valor são inválidos.
+ */
+int pager_setopt(const char *key, const char *value){
+    if(strcmp(key, "policy") == 0){
+        for(size_t i = 0; i < sizeof(policies) / sizeof(policies[0]); i++){
+            if(strcmp(value, policies[i].name) == 0){
+                policy = &policies[i];
+                return 0;
+            }
+        }
+        return -1;
+    }
+    if(strcmp(key, "lowmark") == 0){
+        return option_int(value, &low_watermark);
+    }
+    if(strcmp(key, "highmark") == 0){
+        return option_int(value, &high_watermark);
+    }
+    if(strcmp(key, "pff") == 0){
+        return option_number(value, ULONG_MAX, &pff_threshold);
+    }
+    if(strcmp(key, "readahead") == 0){
+        return option_int(value, &readahead_max);
+    }
+    if(strcmp(key, "faultaround") == 0){
+        unsigned long size;
+        if(option_number(value, FAULTAROUND_MAX, &size) != 0){
+            return -1;
+        }
+        faultaround_pages = (int) size;
+        return 0;
+    }
+    if(strcmp(key, "writeback") == 0){
+        return option_bool(value, &writeback_enabled);
+    }
+    if(strcmp(key, "chprotvec") == 0){
+        return option_bool(value, &chprot_vec_enabled);
+    }
+    if(strcmp(key, "dedup") == 0){
+        return option_int(value, &dedup_interval);
+    }
+    if(strcmp(key, "zswap") == 0){
+        return option_int(value, &zswap_pages);
+    }
+    if(strcmp(key, "overcommit") == 0){
+        const char* modes[] = {"strict", "ratio", "unlimited"};
+        for(int i = 0; i < 3; i++){
+            if(strcmp(value, modes[i]) == 0){
+                overcommit_mode = i;
+                return 0;
+            }
+        }
+        return -1;
+    }
+    if(strcmp(key, "commitratio") == 0){
+        return option_int(value, &overcommit_ratio);
+    }
+    if(strcmp(key, "swapcache") == 0){
+        return option_bool(value, &swap_cache_enabled);
+    }
+    if(strcmp(key, "zeropage") == 0){
+        return option_bool(value, &zero_frame_enabled);
+    }
+    if(strcmp(key, "pinlimit") == 0){
+        return option_int(value, &pin_limit);
+    }
+    const char* limits[] = {"maxresident", "maxswap", "maxpages"};
+    for(int i = 0; i < UVM_LIMIT_COUNT; i++){
+        if(strcmp(key, limits[i]) == 0){
+            return option_number(value, ULONG_MAX, &default_limits[i]);
+        }
+    }
+    if(strcmp(key, "magazine") == 0){
+        unsigned long size;
+        if(option_number(value, MAGAZINE_MAX, &size) != 0){
+            return -1;
+        }
+        magazine_size = (int) size;
+        return 0;
+    }
+    if(strcmp(key, "stats") == 0){
+        return option_bool(value, &stats_report);
+    }
+    return -1;
+}
+
+/**
+ * @brief Define o tamanho da tabela de páginas na memória (frame) e no disco (block), aloca a quantidade de páginas relativas
+ * a esse tamanho para ambas e as inicializa com valores padrão, retornando ao fim o gerenciador de alicação de páginas.
+ * 
+ * @param nframes Número total de quadros em memória principal
+ * @param nblocks Número total de quadros em memória secundária
+ */
+void pager_init(int nframes, int nblocks){
+    pager_page_size = sysconf(_SC_PAGESIZE);
+    pager_num_pages = (UVM_MAXADDR - UVM_BASEADDR + 1) / pager_page_size;
+    frame.size = frame.free = nframes;
+    block.size = block.free = nblocks;
+
+    frame.page_t = (page*) malloc(sizeof(page) * nframes);
+    block.page_t = (page*) malloc(sizeof(page) * nblocks);
+    sc_ptr = 0;
+
+    pt_levels = 1;
+    for(long span = PT_FANOUT; span < NUM_PAGES; span *= PT_FANOUT){
+        pt_levels++;
+    }
+
+    init_page_central(&frame);
+    init_page_central(&block);
+    rs_next = (int*) malloc(sizeof(int) * nframes);
+    rs_prev = (int*) malloc(sizeof(int) * nframes);
+    frame_shares = (frame_share*) calloc(nframes, sizeof(frame_share));
+    cold_ring = (int*) malloc(sizeof(int) * nframes);
+    cold_queued = (unsigned char*) calloc(nframes, sizeof(unsigned char));
+    block_shares = (int*) calloc(nblocks, sizeof(int));
+    if(pin_limit == 0){
+        pin_limit = nframes / 4 > 0 ? nframes / 4 : 1;
+    }
+    if(zswap_pages > 0){
+        zswap_data = (unsigned char**) calloc(nblocks, sizeof(unsigned char*));
+        zswap_len = (int*) calloc(nblocks, sizeof(int));
+        pthread_key_create(&zswap_key, free);
+    }
+    if(policy->init != NULL){
+        policy->init(nframes);
+    }
+
+    manager = vm_registry_create();
+    pthread_rwlock_init(&registry_lock,NULL);
+    pthread_mutex_init(&frame_lock,NULL);
+    pthread_mutex_init(&block_lock,NULL);
+    pthread_mutex_init(&magazine_lock,NULL);
+    pthread_mutex_init(&zero_frame_lock,NULL);
+    pthread_key_create(&magazine_key, magazine_destroy);
+    // Magazines grandes demais em relação às tabelas esconderiam a maior parte das posições livres nas threads.
+    int smallest = nframes < nblocks ? nframes : nblocks;
+    if(magazine_size > smallest / 8){
+        magazine_size = smallest / 8;
+    }
+
+    if(low_watermark > 0){
+        if(low_watermark >= nframes){
+            low_watermark = nframes - 1 > 0 ? nframes - 1 : 1;
+        }
+        if(high_watermark <= low_watermark){
+            high_watermark = low_watermark + 1;
+        }
+        if(high_watermark > nframes){
+            high_watermark = nframes;
+        }
+        min_watermark = low_watermark / 2;
+        pthread_cond_init(&reclaim_cond,NULL);
+        pthread_t reclaim_thread;
+        pthread_create(&reclaim_thread,NULL,reclaim_daemon,NULL);
+        pthread_detach(reclaim_thread);
+    }
+
+    if(dedup_interval > 0){
+        pthread_t dedup_thread;
+        pthread_create(&dedup_thread,NULL,dedup_daemon,NULL);
+        pthread_detach(dedup_thread);
+    }
+
+    if(writeback_enabled){
+        wb_ring = (int*) malloc(sizeof(int) * nframes);
+        wb_queued = (unsigned char*) calloc(nframes, sizeof(unsigned char));
+        wb_head = wb_count = 0;
+        pthread_cond_init(&writeback_cond,NULL);
+        pthread_t writeback_thread;
+        pthread_create(&writeback_thread,NULL,writeback_daemon,NULL);
+        pthread_detach(writeback_thread);
+    }
+}
+
+/**
+ * @brief Essa função cria um novo paginador de memória virtual para o processo informado.
+ * 
+ * @param pid Identificador do processo que se quer criar um paginador.
+ */
+void pager_create(pid_t pid){
+    pthread_rwlock_wrlock(&registry_lock);
+    vm_registry_insert_pid(manager, pid);
+    pthread_rwlock_unlock(&registry_lock);
+}
+
+/**
+ * @brief Verifica se uma nova página pode ser solicitada fora do modo OVERCOMMIT_STRICT: no modo OVERCOMMIT_RATIO, o total de
+ * páginas solicitadas não pode passar de "block.size" mais "overcommit_ratio"% de "frame.size". Deve ser chamada com "block_lock".
+ * 
+ * @param npages Quantidade de páginas a serem solicitadas
+ * @return int 1 - Quando as páginas estão dentro do limite. 0 - Caso contrário.
+ */
+int commit_allowed(long npages){
+    if(overcommit_mode == OVERCOMMIT_UNLIMITED){
+        return 1;
+    }
+    return committed_pages + npages <= block.size + (long) frame.size * overcommit_ratio / 100;
+}
+
+/**
+ * @brief Cria a memória virtual de um processo filho, criado por "uvm_fork", com as páginas do pai em cópia na escrita. Cada entrada
+ * da tabela de páginas do pai é copiada para o filho, sem permissão (o filho retira as permissões herdadas de seus mapeamentos), e
+ * ambas são marcadas com "cow": páginas presentes na memória principal passam a compartilhar o quadro (ver "frame_shares"), e todas
+ * compartilham o bloco (ver "block_shares"). As páginas do pai com permissão de escrita a perdem, com uma única chamada a
+ * "mmu_chprot_vec". Páginas lidas antecipadamente e ainda não acessadas pelo pai não são compartilhadas: o filho as lê do bloco.
+ * 
+ * Como cada página compartilhada pode exigir um bloco próprio em sua primeira escrita, a criação só ocorre se houver blocos livres
+ * para todas elas além da reserva atual ("cow_reserve"), que é aumentada na mesma quantidade. Fora do modo OVERCOMMIT_STRICT, as
+ * páginas do filho apenas entram no limite de compromisso (ver "commit_allowed"), e páginas ainda sem bloco não compartilham bloco.
+ * O filho herda os limites do pai (ver "pager_setlimit").
+ * 
+ * @param parent_pid Identificador do processo pai
+ * @param pid Identificador do processo filho
+ * @return int 0 - Quando o filho foi criado. -1 - Quando o pai não existe ou não há blocos livres suficientes.
+ */
+int pager_fork(pid_t parent_pid, pid_t pid){
+    virtual_memory* parent = vm_acquire(parent_pid);
+    if(parent == NULL){
+        return -1;
+    }
+    long npages = parent->page_ptr + 1;
+    pthread_mutex_lock(&block_lock);
+    int available;
+    if(overcommit_mode == OVERCOMMIT_STRICT){
+        available = block.free - cow_reserve >= npages;
+        if(available){
+            cow_reserve += npages;
+        }
+    }
+    else{
+        available = commit_allowed(npages);
+        if(available){
+            committed_pages += npages;
+        }
+    }
+    pthread_mutex_unlock(&block_lock);
+    if(!available){
+        vm_unlock(parent);
+        return -1;
+    }
+
+    pager_create(pid);
+    virtual_memory* child = vm_acquire(pid);
+    void** downgraded = (void**) malloc(sizeof(void*) * (npages + 1));
+    int ndowngraded = 0;
+
+    frame_lock_process(parent);
+    pthread_mutex_lock(&block_lock);
+    child->page_ptr = parent->page_ptr;
+    memcpy(child->limits, parent->limits, sizeof(child->limits));
+    for(long index = 0; index < npages; index++){
+        page_entry* source = page_table_walk(&parent->page_table, index, 0);
+        page_entry* copy = page_table_walk(&child->page_table, index, 1);
+        *copy = *source;
+        copy->options.permission = PROT_NONE;
+        copy->options.reference_bit = 0;
+        copy->options.prefetched = 0;
+        copy->options.zero = 0;
+        copy->options.cold = 0;
+        copy->options.pinned = 0;
+        copy->ghost = 0;
+        source->options.cow = copy->options.cow = 1;
+        if(source->block != -1){
+            block_shares[source->block]++;
+            block.page_t[source->block].entry = NULL;
+        }
+
+        if(source->state == PAGE_IN_FRAME && source->options.prefetched){
+            copy->state = PAGE_IN_BLOCK;
+            copy->frame = -1;
+        }
+        else if(source->state == PAGE_IN_FRAME){
+            if(frame_shares[source->frame].count == 0){
+                frame_share_add(source->frame, parent, source, INDEX_TO_VIRTUAL_ADDR(index));
+            }
+            frame_share_add(source->frame, child, copy, INDEX_TO_VIRTUAL_ADDR(index));
+            if(source->options.permission & PROT_WRITE){
+                source->options.permission = PROT_READ;
+                downgraded[ndowngraded++] = INDEX_TO_VIRTUAL_ADDR(index);
+            }
+        }
+        if(copy->state == PAGE_IN_BLOCK){
+            child->swapped++;
+        }
+        __sync_fetch_and_add(&stats.cow_shared, 1);
+    }
+    pthread_mutex_unlock(&block_lock);
+    pthread_mutex_unlock(&frame_lock);
+
+    if(ndowngraded > 0){
+        mmu_chprot_vec(parent_pid, downgraded, ndowngraded, PROT_READ);
+    }
+    free(downgraded);
+    vm_unlock(child);
+    vm_unlock(parent);
+    return 0;
+}
+
+/**
+ * @brief Verifica se a memória secundária está disponível, de forma que se não estiver, não ocorre a extensão de páginas da 
+ * memória virtual do processo e é retornado nulo.
+ * Vale lembrar que, para cada página alocada na memória principal pelo processo, também é definida uma página na memória secundária 
+ * para transferência futura, se necessário. Dessa forma, junto com o aumento no número de páginas, o bloco livre de menor índice da
+ * memória secundária "block" é reservado para a nova página.
+ * 
+ * Fora do modo OVERCOMMIT_STRICT, a extensão depende apenas do limite de compromisso ("commit_allowed"), e o bloco só é reservado
+ * quando a página é retirada da memória principal depois de escrita (ver "swap_assign").
+ * 
+ * @param pid Identificador do processo que alocará mais uma página na memória virtual
+ * @return void* Endereço virtual convertido com base na alocação da página.
+ */
+void* pager_extend(pid_t pid){
+    return pager_extend_range(pid, 1);
+}
+
+/**
+ * @brief Estende a memória virtual do processo com "npages" páginas contíguas de uma só vez, como "npages" chamadas a
+ * "pager_extend". A extensão é atômica: a disponibilidade de blocos (ou o limite de compromisso), o espaço de endereçamento e o
+ * limite de páginas do processo (ver "pager_setlimit") são verificados para todas as páginas antes de qualquer uma ser solicitada,
+ * de forma que nenhuma página é solicitada em caso de falha.
+ * 
+ * @param pid Identificador do processo
+ * @param npages Quantidade de páginas
+ * @return void* Endereço virtual da primeira página, ou NULL caso as páginas não possam ser solicitadas.
+ */
+void* pager_extend_range(pid_t pid, int npages){
+    if(npages <= 0){
+        return NULL;
+    }
+    virtual_memory* mem = vm_acquire(pid);
+    if(mem == NULL){
+        return NULL;
+    }
+
+    void* addr = NULL;
+    pthread_mutex_lock(&block_lock);
+    int available = (long) mem->page_ptr + npages < NUM_PAGES;
+    if(mem->limits[UVM_LIMIT_PAGES] != 0 && (unsigned long) mem->page_ptr + 1 + npages > mem->limits[UVM_LIMIT_PAGES]){
+        available = 0;
+    }
+    if(available && overcommit_mode != OVERCOMMIT_STRICT){
+        available = commit_allowed(npages);
+    }
+    else if(available){
+        available = block.free - cow_reserve >= npages;
+    }
+    for(int i = 0; available && i < npages; i++){
+        void* page_addr = vm_increase_pages(mem);
+        if(i == 0){
+            addr = page_addr;
+        }
+        if(overcommit_mode == OVERCOMMIT_STRICT){
+            page reserved;
+            reserved.pid = pid;
+            reserved.vaddr = page_addr;
+            reserved.entry = page_table_walk(&mem->page_table,VIRTUAL_ADDR_TO_INDEX(page_addr),0);
+            magazine_page_alloc(&block,reserved);
+        }
+    }
+    if(available && overcommit_mode != OVERCOMMIT_STRICT){
+        committed_pages += npages;
+    }
+    pthread_mutex_unlock(&block_lock);
+    vm_unlock(mem);
+    return addr;
+}
+
+/**
+ * @brief Trata uma falha na página solicitada "entry" (ver "pager_fault"), avançando um passo de seu estado.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param addr Endereço virtual inicial da página
+ * @param entry Entrada da tabela de páginas
+ * @return int 0 - Quando a falha foi tratada. -1 - Quando falta espaço de troca para atendê-la.
+ */
+int page_fault(virtual_memory* mem, void* addr, page_entry* entry){
+    int status = 0;
+
+    if(entry->state == PAGE_IN_FRAME && entry->options.prefetched){
+        readahead_hit(mem,addr,entry);
+    }
+    else if(entry->state == PAGE_IN_FRAME && entry->options.permission == PROT_READ && entry->options.cow){
+        status = cow_break(mem,addr,entry);
+    }
+    else if(entry->state == PAGE_IN_FRAME){
+        if(entry->options.permission == PROT_NONE){
+            entry->options.permission = PROT_READ;
+        }
+        else if(entry->options.permission == PROT_READ){
+            entry->options.write_op = 1;
+            entry->options.dirty = 1;
+            entry->options.permission = PROT_WRITE | PROT_READ;
+        }
+        entry->options.reference_bit = 1;
+        page_referenced(mem, entry);
+        mmu_chprot(mem->pid,addr,entry->options.permission);
+    }
+    else if(entry->options.zero){
+        status = zero_write(mem,addr,entry);
+    }
+    else if(zero_frame_enabled && entry->state == PAGE_EXTENDED){
+        if(zero_map(mem,addr,entry) == -1){
+            status = page_in(mem,addr,entry);
+        }
+    }
+    else{
+        status = page_in(mem,addr,entry);
+    }
+    return status;
+}
+
+/**
+ * @brief Função para tratamento de falhas de página. Uma única consulta à tabela de páginas do processo informa se o endereço
+ * virtual que se quer acessar está presente na memória principal (PAGE_IN_FRAME), na secundária (PAGE_IN_BLOCK), ou se já houve
+ * ao menos a solicitação de alocação desse endereço (PAGE_EXTENDED).
+ * 
+ * Quando o endereço não foi solicitado pelo processo, a função retorna sem realizar nenhuma ação.
+ * 
+ * Quando o endereço não está em nenhuma das memórias, quer dizer que aquele é o primeiro acesso a ele. Se houver espaço o suficiente
+ * na memória principal, o endereço é alocado a ela. Caso contrário, é executado o algoritmo de segunda chance, buscando um elemento
+ * da memória principal a ser movido para a secundária e, dessa forma, permitir ao programa a utilização do atual endereço. Com a
+ * opção zeropage=1, esse primeiro acesso apenas mapeia o quadro de zeros, e o quadro é alocado na escrita seguinte (ver "zero_write").
+ * 
+ * Quando o endereço acessado já está na memória principal, as permissões dele são alteradas gradualmente a cada acesso. Seguindo a ordem
+ * PROT_NONE -> PROT_READ -> PROT_READ | PROT_WRITE
+ * 
+ * Quando o endereço acessado já está na memória secundária, executamos o algoritmo de segunda chance, buscando o elemento a ser removido. Em seguida
+ * transferimos a pagina do disco para o espaço de frame definido, e a pagina removida recebe seu devido tratamento.
+ * 
+ * Fora do modo OVERCOMMIT_STRICT, a falha pode não ser atendida quando nenhuma página pode ser retirada por falta de blocos livres
+ * (ver "reclaim_frame"); a página continua como estava e o processo é informado pelo retorno -1.
+ * 
+ * @param pid Identificadro do processo ao qual será tratada a falha de página ao acessar o endereço, se necessário.
+ * @param addr Endereço relativo ao processo que se quer acessar.
+ * @return int 0 - Quando a falha foi tratada. -1 - Quando falta espaço de troca para atendê-la.
+ */
+int pager_fault(pid_t pid, void *addr){
+    addr = NORM_VIRTUAL_ADDR(addr);
+    virtual_memory* mem = vm_acquire(pid);
+    if(mem == NULL){
+        return 0;
+    }
+    page_entry* entry = page_table_walk(&mem->page_table,VIRTUAL_ADDR_TO_INDEX(addr),0);
+    
+    if(entry == NULL || entry->state == PAGE_UNUSED){
+        vm_unlock(mem);
+        return 0;
+    }
+
+    mem->faults++;
+    int status = page_fault(mem,addr,entry);
+    if(status == 0 && faultaround_pages > 1 && entry->options.advice != UVM_ADV_RANDOM){
+        fault_around(mem,VIRTUAL_ADDR_TO_INDEX(addr));
+    }
+    vm_unlock(mem);
+    reclaim_wakeup();
+    writeback_wakeup();
+    return status;
+}
+
+
+/**
+ * @brief Essa função é utilizada para imprimir os dados armazenados na memória como bytes (hexadecimais), a partir de um
+ * endereço inicial até o tamanho total informado, sem verificação de permissão do processo em relação à região lida.
+ * 
+ * Para isso, verifica se o intervalo que se quer acessar está dentro do intervalo de memória disponível e se todas as suas
+ * páginas foram solicitadas pelo processo, retornando "-1" caso negativo. Em seguida, cada página do intervalo é acessada
+ * como uma leitura: páginas fora da memória principal são trazidas para ela e páginas sem permissão de leitura a recebem,
+ * de forma que os bytes são lidos do quadro ocupado pela página. Caso falte espaço de troca para trazer alguma página, a
+ * leitura é interrompida e "-1" é retornado.
+ * 
+ * @param pid Identificador do processo que contem o primeiro endereço, cujo conteúdo será exibido
+ * @param addr Endereço da memória virtual contendo o início da região, cujos conteúdos serão exibidos
+ * @param len Tamanho da região total que terá os conteúdos exibidos.
+ * @return int -1 - Quando não foi possível realizar a leitura. 0 - Quando foi possível realizar a leitura.
+ */
+int pager_syslog(pid_t pid, void *addr, size_t len){
+    int addr_under_base = ((long) addr < UVM_BASEADDR);
+    int addr_above_max = ((long) addr > UVM_MAXADDR) || ((long) addr + (long) len - 1 > UVM_MAXADDR);
+    if(addr_under_base || addr_above_max){
+        return -1;
+    }
+
+    virtual_memory* mem = vm_acquire(pid);
+    if(mem == NULL){
+        return -1;
+    }
+    long first = VIRTUAL_ADDR_TO_INDEX(addr);
+    long last = len > 0 ? VIRTUAL_ADDR_TO_INDEX((char*) addr + len - 1) : first;
+    for(long index = first; index <= last; index++){
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(entry == NULL || entry->state == PAGE_UNUSED){
+            vm_unlock(mem);
+            return -1;
+        }
+    }
+
+    long page_size = PAGE_SIZE;
+    size_t done = 0;
+    for(long index = first; done < len; index++){
+        void* vaddr = INDEX_TO_VIRTUAL_ADDR(index);
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(zero_frame_enabled && entry->state == PAGE_EXTENDED && !entry->options.zero){
+            zero_map(mem, vaddr, entry);
+        }
+        if(!entry->options.zero && entry->state != PAGE_IN_FRAME && page_in(mem, vaddr, entry) == -1){
+            printf("\n");
+            vm_unlock(mem);
+            return -1;
+        }
+        else if(entry->options.prefetched){
+            readahead_hit(mem, vaddr, entry);
+        }
+        else if(entry->options.permission == PROT_NONE){
+            entry->options.permission = PROT_READ;
+            page_referenced(mem, entry);
+            mmu_chprot(pid, vaddr, PROT_READ);
+        }
+        entry->options.reference_bit = 1;
+
+        long offset = (index == first) ? (char*) addr - (char*) vaddr : 0;
+        int pos = entry->options.zero ? zero_frame : entry->frame;
+        const char* buf = pmem + (pos * page_size) + offset;
+        for(; offset < page_size && done < len; offset++, done++){
+            printf("%02x", (unsigned)*buf++);
+        }
+    }
+    printf("\n");
+    vm_unlock(mem);
+    return 0;
+}
+
+/**
+ * @brief Descarta o conteúdo de uma página (ver "pager_release"), que volta ao estado de apenas solicitada. A página deixa de ser
+ * mapeada no processo e seu quadro volta a estar livre ou, se compartilhado, deixa de ser mapeado por ela. Fora do modo
+ * OVERCOMMIT_STRICT, o bloco também é devolvido (ou perde uma referência, se compartilhado); no modo OVERCOMMIT_STRICT ele continua
+ * reservado para a página, e apenas seu conteúdo na área comprimida é descartado.
+ * 
+ * @param mem Memória virtual do processo, adquirida pela thread atual
+ * @param vaddr Endereço virtual inicial da página
+ * @param entry Entrada da tabela de páginas
+ */
+void page_release(virtual_memory* mem, void* vaddr, page_entry* entry){
+    page_unpin(mem, entry);
+    if(entry->options.zero || (entry->state == PAGE_IN_FRAME && !entry->options.prefetched)){
+        mmu_nonresident(mem->pid, vaddr);
+    }
+    if(entry->state == PAGE_IN_FRAME){
+        int pos = entry->frame;
+        frame_lock_process(mem);
+        if(frame_shares[pos].count > 0 && frame_share_find(pos, entry) != -1){
+            frame_share_remove(pos, entry);
+            entry->frame = -1;
+        }
+        else{
+            if(policy->on_free != NULL){
+                policy->on_free(pos, 0);
+            }
+            resident_unlink(mem, pos);
+            page_central_release(&frame, pos);
+        }
+        pthread_mutex_unlock(&frame_lock);
+    }
+
+    pthread_mutex_lock(&block_lock);
+    if(entry->block != -1 && overcommit_mode != OVERCOMMIT_STRICT){
+        if(block_shares[entry->block] > 0){
+            block_shares[entry->block]--;
+        }
+        else{
+            zswap_drop(entry->block);
+            page_central_release(&block, entry->block);
+        }
+        entry->block = -1;
+        entry->options.cow = 0;
+    }
+    else if(entry->block != -1 && block_shares[entry->block] == 0){
+        zswap_drop(entry->block);
+    }
+    pthread_mutex_unlock(&block_lock);
+
+    if(entry->state == PAGE_IN_BLOCK){
+        mem->swapped--;
+    }
+    entry->state = PAGE_EXTENDED;
+    entry->options.write_op = 0;
+    entry->options.dirty = 0;
+    entry->options.permission = PROT_NONE;
+    entry->options.reference_bit = 0;
+    entry->options.prefetched = 0;
+    entry->options.zero = 0;
+    entry->options.cold = 0;
+    entry->ghost = 0;
+    __sync_fetch_and_add(&stats.released, 1);
+}
+
+/**
+ * @brief Valida um intervalo informado por um processo e adquire sua memória virtual: o endereço deve ser o início de uma página
+ * entre UVM_BASEADDR e UVM_MAXADDR, e todas as páginas do intervalo devem ter sido solicitadas.
+ * 
+ * @param pid Identificador do processo
+ * @param addr Endereço inicial do intervalo
+ * @param len Tamanho do intervalo, arredondado para cima até o fim da última página
+ * @param first Recebe o índice da primeira página do intervalo
+ * @param last Recebe o índice da última página do intervalo (menor que "first" quando "len" é 0)
+ * @return virtual_memory* A memória virtual adquirida, ou NULL caso o intervalo seja inválido.
+ */
+virtual_memory* range_acquire(pid_t pid, void* addr, size_t len, long* first, long* last){
+    int addr_under_base = ((long) addr < UVM_BASEADDR);
+    int addr_above_max = ((long) addr > UVM_MAXADDR) || ((long) addr + (long) len - 1 > UVM_MAXADDR);
+    if(addr_under_base || addr_above_max || NORM_VIRTUAL_ADDR(addr) != addr){
+        return NULL;
+    }
+
+    virtual_memory* mem = vm_acquire(pid);
+    if(mem == NULL){
+        return NULL;
+    }
+    *first = VIRTUAL_ADDR_TO_INDEX(addr);
+    *last = len > 0 ? VIRTUAL_ADDR_TO_INDEX((char*) addr + len - 1) : *first - 1;
+    for(long index = *first; index <= *last; index++){
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(entry == NULL || entry->state == PAGE_UNUSED){
+            vm_unlock(mem);
+            return NULL;
+        }
+    }
+    return mem;
+}
+
+/**
+ * @brief Descarta as páginas do intervalo informado, como "madvise(MADV_DONTNEED)": seus quadros (e, fora do modo
+ * OVERCOMMIT_STRICT, seus blocos) são devolvidos, e o próximo acesso a cada uma delas a encontra preenchida com zeros. As páginas
+ * continuam solicitadas pelo processo. O endereço deve ser o início de uma página, e todas as páginas do intervalo devem ter sido
+ * solicitadas; caso contrário, nada é descartado.
+ * 
+ * @param pid Identificador do processo
+ * @param addr Endereço inicial do intervalo, alinhado a uma página
+ * @param len Tamanho do intervalo, arredondado para cima até o fim da última página
+ * @return int -1 - Quando o intervalo é inválido. 0 - Quando as páginas foram descartadas.
+ */
+int pager_release(pid_t pid, void *addr, size_t len){
+    long first, last;
+    virtual_memory* mem = range_acquire(pid, addr, len, &first, &last);
+    if(mem == NULL){
+        return -1;
+    }
+    for(long index = first; index <= last; index++){
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(entry->state != PAGE_EXTENDED || entry->options.zero){
+            page_release(mem, INDEX_TO_VIRTUAL_ADDR(index), entry);
+        }
+    }
+    vm_unlock(mem);
+    return 0;
+}
+
+/**
+ * @brief Registra o padrão de acesso informado pelo processo para as páginas do intervalo ("uvm_advise"):
+ * UVM_ADV_NORMAL - Desfaz as indicações UVM_ADV_SEQUENTIAL e UVM_ADV_RANDOM.
+ * UVM_ADV_SEQUENTIAL - Toda falha que traz uma das páginas do disco lê antecipadamente as seguintes, mesmo sem a opção readahead, e
+ * as páginas que ficam para trás tornam-se frias (ver "drop_behind").
+ * UVM_ADV_RANDOM - As falhas nas páginas não iniciam leitura antecipada nem falha em torno.
+ * UVM_ADV_WILLNEED - As páginas guardadas em disco são lidas antecipadamente (até metade dos quadros), sem serem mapeadas.
+ * UVM_ADV_DONTNEED - As páginas são descartadas (ver "pager_release").
+ * UVM_ADV_COLD - As páginas presentes na memória principal tornam-se frias, sendo as primeiras vítimas da substituição global.
+ * 
+ * @param pid Identificador do processo
+ * @param addr Endereço inicial do intervalo, alinhado a uma página
+ * @param len Tamanho do intervalo
+ * @param advice Padrão de acesso
+ * @return int -1 - Quando o intervalo ou o padrão são inválidos. 0 - Caso contrário.
+ */
+int pager_advise(pid_t pid, void *addr, size_t len, int advice){
+    if(advice == UVM_ADV_DONTNEED){
+        return pager_release(pid, addr, len);
+    }
+    if(advice < UVM_ADV_NORMAL || advice > UVM_ADV_COLD){
+        return -1;
+    }
+    long first, last;
+    virtual_memory* mem = range_acquire(pid, addr, len, &first, &last);
+    if(mem == NULL){
+        return -1;
+    }
+    int budget = frame.size / 2;
+    for(long index = first; index <= last; index++){
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(advice == UVM_ADV_NORMAL || advice == UVM_ADV_SEQUENTIAL || advice == UVM_ADV_RANDOM){
+            entry->options.advice = advice;
+        }
+        else if(advice == UVM_ADV_WILLNEED){
+            if(entry->state == PAGE_IN_BLOCK && (budget-- <= 0 || prefetch_page(mem, index, entry) == -1)){
+                break;
+            }
+        }
+        else if(entry->state == PAGE_IN_FRAME && !entry->options.prefetched){
+            frame_lock_process(mem);
+            cold_mark(entry);
+            pthread_mutex_unlock(&frame_lock);
+        }
+    }
+    vm_unlock(mem);
+    return 0;
+}
+
+/**
+ * @brief Fixa na memória principal as páginas do intervalo informado ("uvm_lock"), como "mlock". Cada página é trazida para a
+ * memória principal com ao menos permissão de leitura (ver "page_fault") e deixa de ser candidata à substituição; como suas
+ * permissões não são mais retiradas, suas leituras não causam falhas até "pager_unlock". A primeira escrita em uma página fixada
+ * apenas com leitura ainda causa uma falha, que concede a permissão de escrita. O processo pode fixar até "pin_limit" páginas, e
+ * todos os processos juntos até metade dos quadros. Páginas já fixadas não contam novamente.
+ * 
+ * @param pid Identificador do processo
+ * @param addr Endereço inicial do intervalo, alinhado a uma página
+ * @param len Tamanho do intervalo
+ * @return int 0 - Quando as páginas foram fixadas. -1 - Quando o intervalo é inválido. -2 - Quando o limite seria ultrapassado ou
+ * falta espaço de troca para trazer alguma página; nesse caso nenhuma página é fixada pela chamada.
+ */
+int pager_lock(pid_t pid, void *addr, size_t len){
+    long first, last;
+    virtual_memory* mem = range_acquire(pid, addr, len, &first, &last);
+    if(mem == NULL){
+        return -1;
+    }
+    int needed = 0;
+    int needed_frames = 0;
+    for(long index = first; index <= last; index++){
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(!entry->options.pinned){
+            needed++;
+            needed_frames += !entry->options.zero && !(zero_frame_enabled && entry->state == PAGE_EXTENDED);
+        }
+    }
+    frame_lock_process(mem);
+    int allowed = mem->pinned + needed <= pin_limit && pinned_total + needed_frames <= frame.size / 2;
+    if(allowed){
+        mem->pinned += needed;
+        pinned_total += needed_frames;
+    }
+    pthread_mutex_unlock(&frame_lock);
+    if(!allowed){
+        vm_unlock(mem);
+        return -2;
+    }
+
+    // As páginas fixadas por esta chamada são reservadas acima e marcadas uma a uma, logo que ficam presentes com permissão de
+    // leitura, para que a vinda das seguintes não as retire. A permissão de escrita só é concedida por uma escrita real, de forma
+    // que fixar uma região apenas lida não a torna suja nem desfaz o compartilhamento de seus quadros. Uma página que mapeia o
+    // quadro de zeros já está presente e não ocupa quadro próprio: o quadro de zeros nunca é retirado, e ela só passa a contar em
+    // "pinned_total" na primeira escrita (ver "zero_write"). Uma página que se esperava mapear no quadro de zeros, mas recebeu um
+    // quadro próprio, ocupa um dos quadros fixáveis restantes.
+    long* pinned_now = (long*) malloc(sizeof(long) * (needed + 1));
+    int npinned = 0;
+    int status = 0;
+    for(long index = first; index <= last && status == 0; index++){
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(entry->options.pinned){
+            continue;
+        }
+        void* vaddr = INDEX_TO_VIRTUAL_ADDR(index);
+        while(status == 0 && !entry->options.zero && (entry->state != PAGE_IN_FRAME || entry->options.prefetched ||
+                entry->options.permission == PROT_NONE)){
+            status = page_fault(mem, vaddr, entry);
+        }
+        if(status == 0){
+            frame_lock_process(mem);
+            if(entry->options.zero){
+                mem->pinned_zero++;
+            }
+            else if(needed_frames > 0){
+                needed_frames--;
+            }
+            else if(pinned_total < frame.size / 2){
+                pinned_total++;
+            }
+            else{
+                status = -1;
+            }
+            if(status == 0){
+                entry->options.pinned = 1;
+                entry->options.cold = 0;
+                needed--;
+            }
+            pthread_mutex_unlock(&frame_lock);
+            if(status == 0){
+                pinned_now[npinned++] = index;
+                __sync_fetch_and_add(&stats.pins, 1);
+            }
+        }
+    }
+    if(status != 0){
+        for(int i = 0; i < npinned; i++){
+            page_unpin(mem, page_table_walk(&mem->page_table, pinned_now[i], 0));
+        }
+    }
+    free(pinned_now);
+    frame_lock_process(mem);
+    mem->pinned -= needed;
+    pinned_total -= needed_frames;
+    pthread_mutex_unlock(&frame_lock);
+    vm_unlock(mem);
+    return status == 0 ? 0 : -2;
+}
+
+/**
+ * @brief Desfaz a fixação das páginas do intervalo informado ("uvm_unlock"), que voltam a ser candidatas à substituição.
+ * 
+ * @param pid Identificador do processo
+ * @param addr Endereço inicial do intervalo, alinhado a uma página
+ * @param len Tamanho do intervalo
+ * @return int -1 - Quando o intervalo é inválido. 0 - Caso contrário.
+ */
+int pager_unlock(pid_t pid, void *addr, size_t len){
+    long first, last;
+    virtual_memory* mem = range_acquire(pid, addr, len, &first, &last);
+    if(mem == NULL){
+        return -1;
+    }
+    for(long index = first; index <= last; index++){
+        page_unpin(mem, page_table_walk(&mem->page_table, index, 0));
+    }
+    vm_unlock(mem);
+    return 0;
+}
+
+/**
+ * @brief Define um dos limites de um processo ("uvm_setlimit"), como "setrlimit". As falhas de um processo que ocupa todos os
+ * quadros de seu limite substituem suas próprias páginas (ver "resident_limited"); quadros com páginas de um processo que atingiu o
+ * limite de páginas em disco não são retirados caso suas páginas precisem ser escritas (ver "swap_limited"), de forma que as falhas
+ * do processo podem ficar sem vítima e falhar; "pager_extend" falha para um processo que atingiu seu limite de páginas. Um limite
+ * menor que o uso atual é atingido à medida que o processo sofre falhas: seu conjunto residente deixa de crescer, mas os quadros
+ * excedentes só são liberados quando escolhidos pela substituição global.
+ * 
+ * @param pid Identificador do processo
+ * @param resource Recurso limitado (UVM_LIMIT_RESIDENT, UVM_LIMIT_SWAP ou UVM_LIMIT_PAGES)
+ * @param limit Novo limite, ou 0 para remover o limite
+ * @return int 0 - Quando o limite foi definido. -1 - Quando o recurso é inválido. -2 - Quando o processo não existe.
+ */
+int pager_setlimit(pid_t pid, int resource, unsigned long limit){
+    if(resource < 0 || resource >= UVM_LIMIT_COUNT){
+        return -1;
+    }
+    virtual_memory* mem = vm_acquire(pid);
+    if(mem == NULL){
+        return -2;
+    }
+    mem->limits[resource] = limit;
+    vm_unlock(mem);
+    return 0;
+}
+
+/**
+ * @brief Preenche os contadores de uso e os limites de um processo ("uvm_getusage"). As páginas sujas são contadas percorrendo a
+ * tabela de páginas do processo, de forma que apenas a consulta, e não o tratamento das falhas, tem esse custo.
+ * 
+ * @param pid Identificador do processo
+ * @param usage Contadores a serem preenchidos
+ * @return int 0 - Quando os contadores foram preenchidos. -1 - Quando o processo não existe.
+ */
+int pager_getusage(pid_t pid, struct uvm_usage *usage){
+    virtual_memory* mem = vm_acquire(pid);
+    if(mem == NULL){
+        return -1;
+    }
+    unsigned long dirty = 0;
+    for(long index = 0; index <= mem->page_ptr; index++){
+        page_entry* entry = page_table_walk(&mem->page_table, index, 0);
+        if(entry->state == PAGE_IN_FRAME && entry->options.dirty){
+            dirty++;
+        }
+    }
+    frame_lock_process(mem);
+    usage->resident = mem->resident;
+    pthread_mutex_unlock(&frame_lock);
+    usage->swapped = mem->swapped;
+    usage->dirty = dirty;
+    usage->faults = mem->faults;
+    usage->pages = mem->page_ptr + 1;
+    memcpy(usage->limits, mem->limits, sizeof(usage->limits));
+    vm_unlock(mem);
+    return 0;
+}
+
+/**
+ * @brief Destrói todas as páginas relativas a um processo, tanto na tabela de páginas da memória principal
+ * quanto da secundária, removendo a memória virtual associada a ele ao final. Apenas as páginas presentes na
+ * tabela de páginas do processo são visitadas.
+ * 
+ * A MMU também chama esta função quando a comunicação com um processo falha, o que pode ocorrer dentro de uma
+ * chamada à MMU feita pela própria thread com o lock do processo adquirido. Nesse caso o processo é apenas marcado
+ * como destruído, e suas páginas são liberadas quando a thread liberar o lock (ver "vm_unlock").
+ * 
+ * @param pid Identificador do processo que foi finalizado, tendo a memória desalocada.
+ */
+void pager_destroy(pid_t pid){
+    pthread_rwlock_wrlock(&registry_lock);
+    virtual_memory* mem = vm_registry_remove_pid(manager,pid);
+    int last = manager->size == 0;
+    pthread_rwlock_unlock(&registry_lock);
+    if(mem == NULL){
+        return;
+    }
+
+    if(mem->held && pthread_equal(mem->holder, pthread_self())){
+        mem->dead = 1;
+    }
+    else{
+        pthread_mutex_lock(&mem->lock);
+        mem->dead = 1;
+        vm_teardown(mem);
+        pthread_mutex_unlock(&mem->lock);
+    }
+    vm_put(mem);
 
-    vm_list_remove_pid(manager,pid);
-    pthread_mutex_unlock(&lock);
+    if(stats_report && last){
+        stats_print();
+    }
 }
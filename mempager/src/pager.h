@@ -7,25 +7,77 @@
 
 #include <sys/types.h>
 
+#include "uvm.h"
+
 /* `pager_init` is called by the memory management infrastructure to
  * initialize the pager.  `nframes` and `nblocks` are the number of
  * physical memory frames available and the number of blocks for
  * backing store, respectively. */
 void pager_init(int nframes, int nblocks);
 
+/* `pager_setopt` is called by the memory management infrastructure
+ * before `pager_init` for each `KEY=VALUE` argument given to the MMU
+ * after NFRAMES and NBLOCKS.  It returns 0 if the option was accepted
+ * and -1 if `key` or `value` are invalid; numeric values must be
+ * non-negative decimal numbers with no trailing characters, and the
+ * switches `writeback`, `chprotvec`, `swapcache`, `zeropage` and
+ * `stats` accept only 0 or 1.  Recognized options:
+ * `policy` selects the page replacement policy (clock, lru, clockpro,
+ * 2q, arc or nru; clock is the default), `lowmark` and `highmark` set
+ * the free-frame watermarks of the reclaim daemon, `pff` sets the
+ * page-fault-frequency threshold of per-process budgets, `readahead`
+ * and `faultaround` set the swap read-around window and fault-around
+ * block size in pages (at most 64), `writeback=1` enables background
+ * cleaning, `chprotvec=1` batches the protection changes of a
+ * replacement sweep, `dedup` sets the interval in milliseconds between
+ * scans that merge frames with identical content, `zswap` sets the
+ * size in pages of a compressed in-memory swap pool used before disk
+ * blocks, `overcommit` selects how disk blocks are committed (strict
+ * reserves one per page in `pager_extend` and is the default; ratio
+ * and unlimited assign blocks only when written pages are evicted,
+ * ratio limiting pages to NBLOCKS plus `commitratio` percent of
+ * NFRAMES), `swapcache=1` keeps disk blocks valid after swap-in so
+ * clean pages are evicted without a write, `zeropage=1` maps a shared
+ * zero frame on first-touch reads (the frame is taken from the free
+ * frames on the first such read and never returned), `pinlimit` sets how many pages
+ * each process may pin with `uvm_lock` (NFRAMES/4 by default),
+ * `maxresident`, `maxswap` and `maxpages` set the limits every
+ * process starts with (see `pager_setlimit`; 0, the default, means
+ * unlimited), `magazine` sets how many free frames and blocks each
+ * MMU thread caches for itself (off by default, since a cached frame
+ * is not always the lowest-numbered free one) and `stats=1` prints
+ * the pager counters whenever the last process is destroyed. */
+int pager_setopt(const char *key, const char *value);
+
 /* `pager_create` should initialize any resources the pager needs to
  * manage memory for a new process `pid`. */
 void pager_create(pid_t pid);
 
+/* `pager_fork` is called by the memory management infrastructure
+ * when process `child`, created with `uvm_fork`, connects.  The
+ * child receives all pages of `parent` with copy-on-write semantics:
+ * both share frames and disk blocks until one of them writes to a
+ * page.  Returns 0 on success and -1 if `parent` does not exist or
+ * the disk could not hold a private copy of every shared page. */
+int pager_fork(pid_t parent, pid_t child);
+
 /* `pager_extend` allocates a new page of memory to process `pid`
  * and returns a pointer to that memory in the process's address
  * space.  `pager_extend` need not zero memory or install mappings
  * in the infrastructure until the application actually accesses the
  * page (which will trigger a call to `pager_fault`).
  * `pager_extend` should return NULL is there are no disk blocks to
- * use as backing storage. */
+ * use as backing storage (or, with overcommit, when the commit limit
+ * is reached). */
 void *pager_extend(pid_t pid);
 
+/* `pager_extend_range` allocates `npages` contiguous pages to process
+ * `pid`, as `npages` calls to `pager_extend` would, and returns the
+ * address of the first one.  The range is allocated atomically: if
+ * any page cannot be backed (or the address space is exhausted), no
+ * page is allocated and NULL is returned. */
+void *pager_extend_range(pid_t pid, int npages);
+
 /* `pager_fault` is called when process `pid` receives
  * a segmentation fault at address `addr`.  `pager_fault` is only
  * called for addresses previously returned with `pager_extend`.  If
@@ -37,8 +89,11 @@ void *pager_extend(pid_t pid);
  * accesses the same (i.e., do not prioritize either).  As the
  * memory management infrastructure does not maintain page access
  * and writing information, your pager must track this information
- * to implement the second-chance algorithm. */
-void pager_fault(pid_t pid, void *addr);
+ * to implement the second-chance algorithm.  Returns 0 when the
+ * fault was serviced and -1 when, with overcommit, no page could be
+ * evicted for lack of free disk blocks; the faulting process is then
+ * terminated by the infrastructure. */
+int pager_fault(pid_t pid, void *addr);
 
 /* `pager_syslog prints a message made of `len` bytes following
  * `addr` in the address space of process `pid`.  `pager_syslog`
@@ -49,6 +104,63 @@ void pager_fault(pid_t pid, void *addr);
  * the syslog succeeds, it should return 0. */
 int pager_syslog(pid_t pid, void *addr, size_t len);
 
+/* `pager_release` is called when process `pid` gives back the pages
+ * covering `len` bytes from `addr`, which must be page-aligned, with
+ * `uvm_release`.  Their content is dropped, as with
+ * `madvise(MADV_DONTNEED)`: frames are freed (and, with overcommit,
+ * disk blocks too), and the next access to each page finds it
+ * zero-filled.  The pages remain allocated.  Returns 0 on success
+ * and -1 if the range is not aligned or covers unallocated pages. */
+int pager_release(pid_t pid, void *addr, size_t len);
+
+/* `pager_advise` is called when process `pid` describes with
+ * `uvm_advise` how it will access the pages covering `len` bytes from
+ * `addr` (one of the `UVM_ADV_*` constants in uvm.h).  Sequential
+ * pages are read ahead on every fault and dropped behind the scan,
+ * random pages are never read ahead or faulted around, WILLNEED
+ * pages on disk are read ahead at once, DONTNEED is
+ * `pager_release`, and COLD resident pages become the first victims
+ * of global replacement.  Returns 0 on success and -1 if the range
+ * is invalid (as in `pager_release`) or the advice is unknown. */
+int pager_advise(pid_t pid, void *addr, size_t len, int advice);
+
+/* `pager_lock` is called when process `pid` pins the pages covering
+ * `len` bytes from `addr` with `uvm_lock`.  Each page is brought into
+ * memory with at least read access, and its frame is skipped by
+ * page replacement until `pager_unlock` is called for it, so its
+ * access is never revoked; the first write to a page pinned
+ * read-only still faults to gain write access.  Returns 0 on success, -1
+ * if the range is invalid (as in `pager_release`) and -2 if the
+ * per-process limit (option `pinlimit`) or the global limit of half
+ * the frames would be exceeded, or the swap ran out while faulting
+ * the pages in; on failure no page is pinned by the call.  Pages
+ * mapped to the shared zero frame count toward `pinlimit` but not
+ * toward the global limit until their first write. */
+int pager_lock(pid_t pid, void *addr, size_t len);
+
+/* `pager_unlock` undoes `pager_lock` for the pages covering `len`
+ * bytes from `addr`.  Returns 0 on success and -1 if the range is
+ * invalid. */
+int pager_unlock(pid_t pid, void *addr, size_t len);
+
+/* `pager_setlimit` is called when a process limits one resource
+ * (`UVM_LIMIT_RESIDENT`, `UVM_LIMIT_SWAP` or `UVM_LIMIT_PAGES`) of
+ * process `pid` with `uvm_setlimit`; `limit` 0 means unlimited.
+ * Faults of a process at its resident limit replace its own pages
+ * instead of taking frames from other processes; pages of a process
+ * at its swap limit are not paged out if they would need to be
+ * written to disk; `pager_extend` fails for a process at its page
+ * limit.  A lower limit takes effect as the process faults: its
+ * resident set never grows above the limit, but it keeps its frames
+ * until they are replaced.  Returns 0 on success, -1 if the
+ * resource is unknown and -2 if the process does not exist. */
+int pager_setlimit(pid_t pid, int resource, unsigned long limit);
+
+/* `pager_getusage` fills `usage` with the counters and limits of
+ * process `pid` (see `struct uvm_usage`).  Returns 0 on success and
+ * -1 if the process does not exist. */
+int pager_getusage(pid_t pid, struct uvm_usage *usage);
+
 /* `pager_destroy` is called when the process is already dead.  It
  * should free all resources process `pid` allocated (memory frames
  * and disk blocks).  `pager_destroy` should not call any of the MMU
@@ -9,6 +9,7 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/un.h>
+#include <sys/wait.h>
 
 #include <assert.h>
 #include <errno.h>
@@ -39,23 +40,35 @@ struct uvm_data {/*{{{*/
 	char *pmem_fn;
 	int pmem_fd;
 	intptr_t result;
+	struct uvm_usage *usage;
 };/*}}}*/
 
 static struct uvm_data *uvm = NULL;
+intptr_t uvm_maxaddr = UVM_DEFAULT_MAXADDR;
 
 /****************************************************************************
  * static function declarations
  ***************************************************************************/
 static void * uvm_thread(void *data);
+static void uvm_fork_child(pid_t ppid, int fd);
 static void uvm_exit(int status, void *arg);
 static void uvm_segv_action(int signum, siginfo_t *si, void *context);
 
 /* Protocol message handlers assume assume `uvm->mutex` is locked. */
+static void uvm_dispatch(uint32_t type);
 static void uvm_proto_extend_rep(void);
+static void uvm_proto_extend_range_rep(void);
 static void uvm_proto_syslog_rep(void);
+static void uvm_proto_release_rep(void);
+static void uvm_proto_advise_rep(void);
+static void uvm_proto_lock_rep(void);
+static void uvm_proto_unlock_rep(void);
+static void uvm_proto_setlimit_rep(void);
+static void uvm_proto_usage_rep(void);
 static void uvm_proto_segv_rep(void);
 static void uvm_proto_remap_rep(void);
 static void uvm_proto_chprot_rep(void);
+static void uvm_proto_chprot_vec_rep(void);
 
 /* Helper functions */
 static void uvm_connect_socket(int sock, const struct sockaddr_un * addr);
@@ -80,6 +93,7 @@ void uvm_create(void)/*{{{*/
 	if(!uvm) prexit();
 	uvm->running = 1;
 	uvm->npages = 0;
+	uvm->usage = NULL;
 
 	logd(LOG_DEBUG, "  connecting unix socket [%s]\n", MMU_PROTO_UNIX_PATH);
 	uvm->sock = socket(AF_UNIX, SOCK_STREAM, 0);
@@ -104,6 +118,7 @@ void uvm_create(void)/*{{{*/
 	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep)) prexit();
 	assert(rep.type == MMU_PROTO_CREATE_REP);
 
+	uvm_maxaddr = (intptr_t)rep.maxaddr;
 	uvm->pmem_fn = strndup(rep.pmem_fn, MMU_PROTO_PATH_MAX);
 	logd(LOG_DEBUG, "  mapping pmem_fn [%s]\n", uvm->pmem_fn);
 	uvm->pmem_fd = open(uvm->pmem_fn, O_RDWR);
@@ -141,8 +156,63 @@ void * uvm_extend(void) {/*{{{*/
 	return (void *)uvm->result;
 }/*}}}*/
 
+void * uvm_extend_n(size_t n) {/*{{{*/
+	if(n == 0 || n > UINT32_MAX) {
+		errno = n ? ENOSPC : EINVAL;
+		return NULL;
+	}
+	pthread_mutex_lock(&uvm->mutex);
+	struct mmu_proto_extend_range_req req;
+	req.type = MMU_PROTO_EXTEND_RANGE_REQ;
+	req.count = (uint32_t)n;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req))
+		prexit();
+	pthread_cond_wait(&uvm->cond, &uvm->mutex);
+	if(uvm->result) uvm->npages += n;
+	else errno = ENOSPC;
+	pthread_mutex_unlock(&uvm->mutex);
+	return (void *)uvm->result;
+}/*}}}*/
+
+pid_t uvm_fork(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "uvm_fork starting\n");
+	int fds[2];
+	if(pipe(fds) == -1) return -1;
+	pid_t ppid = getpid();
+	pid_t pid = fork();
+	if(pid == -1) {
+		close(fds[0]);
+		close(fds[1]);
+		return -1;
+	}
+	if(pid == 0) {
+		close(fds[0]);
+		uvm_fork_child(ppid, fds[1]);
+		return 0;
+	}
+
+	/* wait until the pager has write-protected our pages: */
+	close(fds[1]);
+	char status = 1;
+	if(read(fds[0], &status, sizeof(status)) != sizeof(status))
+		status = 1;
+	close(fds[0]);
+	if(status) {
+		waitpid(pid, NULL, 0);
+		errno = ENOMEM;
+		return -1;
+	}
+	logd(LOG_DEBUG, "uvm_fork succeeded [%d]\n", (int)pid);
+	return pid;
+}/*}}}*/
+
 int uvm_syslog(void *addr, size_t len)/*{{{*/
 {
+	if(len > UINT32_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
 	pthread_mutex_lock(&uvm->mutex);
 	struct mmu_proto_syslog_req req;
 	req.type = MMU_PROTO_SYSLOG_REQ;
@@ -156,6 +226,119 @@ int uvm_syslog(void *addr, size_t len)/*{{{*/
 	return (int)uvm->result;
 }/*}}}*/
 
+int uvm_release(void *addr, size_t len)/*{{{*/
+{
+	if(len > UINT32_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+	pthread_mutex_lock(&uvm->mutex);
+	struct mmu_proto_release_req req;
+	req.type = MMU_PROTO_RELEASE_REQ;
+	req.addr = (intptr_t)addr;
+	req.len = len;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req))
+		prexit();
+	pthread_cond_wait(&uvm->cond, &uvm->mutex);
+	if(uvm->result != 0) errno = EINVAL;
+	pthread_mutex_unlock(&uvm->mutex);
+	return (int)uvm->result;
+}/*}}}*/
+
+int uvm_advise(void *addr, size_t len, int advice)/*{{{*/
+{
+	if(len > UINT32_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+	pthread_mutex_lock(&uvm->mutex);
+	struct mmu_proto_advise_req req;
+	req.type = MMU_PROTO_ADVISE_REQ;
+	req.advice = advice;
+	req.addr = (intptr_t)addr;
+	req.len = len;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req))
+		prexit();
+	pthread_cond_wait(&uvm->cond, &uvm->mutex);
+	if(uvm->result != 0) errno = EINVAL;
+	pthread_mutex_unlock(&uvm->mutex);
+	return (int)uvm->result;
+}/*}}}*/
+
+int uvm_lock(void *addr, size_t len)/*{{{*/
+{
+	if(len > UINT32_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+	pthread_mutex_lock(&uvm->mutex);
+	struct mmu_proto_lock_req req;
+	req.type = MMU_PROTO_LOCK_REQ;
+	req.addr = (intptr_t)addr;
+	req.len = len;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req))
+		prexit();
+	pthread_cond_wait(&uvm->cond, &uvm->mutex);
+	int r = (int)uvm->result;
+	if(r == -1) errno = EINVAL;
+	if(r == -2) errno = ENOMEM;
+	pthread_mutex_unlock(&uvm->mutex);
+	return r == 0 ? 0 : -1;
+}/*}}}*/
+
+int uvm_unlock(void *addr, size_t len)/*{{{*/
+{
+	if(len > UINT32_MAX) {
+		errno = EINVAL;
+		return -1;
+	}
+	pthread_mutex_lock(&uvm->mutex);
+	struct mmu_proto_unlock_req req;
+	req.type = MMU_PROTO_UNLOCK_REQ;
+	req.addr = (intptr_t)addr;
+	req.len = len;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req))
+		prexit();
+	pthread_cond_wait(&uvm->cond, &uvm->mutex);
+	if(uvm->result != 0) errno = EINVAL;
+	pthread_mutex_unlock(&uvm->mutex);
+	return (int)uvm->result;
+}/*}}}*/
+
+int uvm_setlimit(pid_t pid, int resource, unsigned long limit)/*{{{*/
+{
+	pthread_mutex_lock(&uvm->mutex);
+	struct mmu_proto_setlimit_req req;
+	req.type = MMU_PROTO_SETLIMIT_REQ;
+	req.pid = (uint32_t)pid;
+	req.resource = resource;
+	req.limit = limit;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req))
+		prexit();
+	pthread_cond_wait(&uvm->cond, &uvm->mutex);
+	int r = (int)uvm->result;
+	if(r == -1) errno = EINVAL;
+	if(r == -2) errno = ESRCH;
+	pthread_mutex_unlock(&uvm->mutex);
+	return r == 0 ? 0 : -1;
+}/*}}}*/
+
+int uvm_getusage(pid_t pid, struct uvm_usage *usage)/*{{{*/
+{
+	pthread_mutex_lock(&uvm->mutex);
+	struct mmu_proto_usage_req req;
+	req.type = MMU_PROTO_USAGE_REQ;
+	req.pid = (uint32_t)pid;
+	uvm->usage = usage;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req))
+		prexit();
+	pthread_cond_wait(&uvm->cond, &uvm->mutex);
+	uvm->usage = NULL;
+	if(uvm->result != 0) errno = ESRCH;
+	pthread_mutex_unlock(&uvm->mutex);
+	return uvm->result == 0 ? 0 : -1;
+}/*}}}*/
+
 /****************************************************************************
  * auxiliary functions
  ***************************************************************************/
@@ -173,35 +356,122 @@ void * uvm_thread(void *data) {/*{{{*/
 		if(!uvm->running) break;
 		if(c != sizeof(type)) prexit();
 		pthread_mutex_lock(&uvm->mutex);
-		switch(type) {
-			case MMU_PROTO_EXTEND_REP:
-				uvm_proto_extend_rep();
-				break;
-			case MMU_PROTO_SYSLOG_REP:
-				uvm_proto_syslog_rep();
-				break;
-			case MMU_PROTO_SEGV_REP:
-				uvm_proto_segv_rep();
-				break;
-			case MMU_PROTO_REMAP_REP:
-				uvm_proto_remap_rep();
-				break;
-			case MMU_PROTO_CHPROT_REP:
-				uvm_proto_chprot_rep();
-				break;
-			case MMU_PROTO_EXIT_REP:
-				uvm->running = 0;
-				break;
-			default:
-				prexit();
-				break;
-		}
+		uvm_dispatch(type);
 		pthread_mutex_unlock(&uvm->mutex);
 	}
 	logd(LOG_DEBUG, "uvm_thread exiting\n");
 	pthread_exit(NULL);
 }/*}}}*/
 
+void uvm_dispatch(uint32_t type)/*{{{*/
+{
+	switch(type) {
+		case MMU_PROTO_EXTEND_REP:
+			uvm_proto_extend_rep();
+			break;
+		case MMU_PROTO_EXTEND_RANGE_REP:
+			uvm_proto_extend_range_rep();
+			break;
+		case MMU_PROTO_SYSLOG_REP:
+			uvm_proto_syslog_rep();
+			break;
+		case MMU_PROTO_RELEASE_REP:
+			uvm_proto_release_rep();
+			break;
+		case MMU_PROTO_ADVISE_REP:
+			uvm_proto_advise_rep();
+			break;
+		case MMU_PROTO_LOCK_REP:
+			uvm_proto_lock_rep();
+			break;
+		case MMU_PROTO_UNLOCK_REP:
+			uvm_proto_unlock_rep();
+			break;
+		case MMU_PROTO_SETLIMIT_REP:
+			uvm_proto_setlimit_rep();
+			break;
+		case MMU_PROTO_USAGE_REP:
+			uvm_proto_usage_rep();
+			break;
+		case MMU_PROTO_SEGV_REP:
+			uvm_proto_segv_rep();
+			break;
+		case MMU_PROTO_REMAP_REP:
+			uvm_proto_remap_rep();
+			break;
+		case MMU_PROTO_CHPROT_REP:
+			uvm_proto_chprot_rep();
+			break;
+		case MMU_PROTO_CHPROT_VEC_REP:
+			uvm_proto_chprot_vec_rep();
+			break;
+		case MMU_PROTO_EXIT_REP:
+			uvm->running = 0;
+			break;
+		default:
+			prexit();
+			break;
+	}
+}/*}}}*/
+
+void uvm_fork_child(pid_t ppid, int fd)/*{{{*/
+{
+	/* our mappings still point to the parent's frames, with the
+	 * parent's permissions; the pager starts us without access: */
+	size_t pagesz = sysconf(_SC_PAGESIZE);
+	if(uvm->npages > 0 && mprotect((void *)UVM_BASEADDR,
+				uvm->npages * pagesz, PROT_NONE) == -1)
+		prexit();
+
+	close(uvm->sock);
+	uvm->running = 1;
+	pthread_mutex_init(&uvm->mutex, NULL);
+	pthread_cond_init(&uvm->cond, NULL);
+
+	logd(LOG_DEBUG, "  connecting unix socket [%s]\n", MMU_PROTO_UNIX_PATH);
+	uvm->sock = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(uvm->sock == -1)
+		prexit();
+	struct sockaddr_un addr;
+	addr.sun_family = AF_UNIX;
+	addr.sun_path[0] = '\0';
+	strncat(addr.sun_path, MMU_PROTO_UNIX_PATH, MMU_PROTO_PATH_MAX-1);
+	uvm_connect_socket(uvm->sock, &addr);
+
+	logd(LOG_DEBUG, "  sending FORK_REQ [%d %d]\n", (int)getpid(), (int)ppid);
+	struct mmu_proto_fork_req req;
+	req.type = MMU_PROTO_FORK_REQ;
+	req.pid = (uint32_t)getpid();
+	req.ppid = (uint32_t)ppid;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req))
+		prexit();
+
+	logd(LOG_DEBUG, "  waiting FORK_REP\n");
+	struct mmu_proto_fork_rep rep;
+	pthread_mutex_lock(&uvm->mutex);
+	while(1) {
+		uint32_t type;
+		if(recv(uvm->sock, &type, sizeof(type), MSG_PEEK) != sizeof(type))
+			prexit();
+		if(type == MMU_PROTO_FORK_REP) break;
+		uvm_dispatch(type);
+	}
+	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep)) prexit();
+	pthread_mutex_unlock(&uvm->mutex);
+
+	char status = rep.retcode != 0;
+	if(write(fd, &status, sizeof(status)) != sizeof(status)) prexit();
+	close(fd);
+	if(status) {
+		/* not bound to the MMU, skip uvm_exit(): */
+		_exit(EXIT_FAILURE);
+	}
+
+	logd(LOG_DEBUG, "  starting uvm_thread()\n");
+	pthread_create(&uvm->thread, NULL, uvm_thread, NULL);
+	logd(LOG_DEBUG, "uvm_fork_child succeeded\n");
+}/*}}}*/
+
 void uvm_exit(int status, void *arg)/*{{{*/
 {
 	logd(LOG_DEBUG, "uvm_exit running\n");
@@ -251,6 +521,12 @@ void uvm_segv_action(int signum, siginfo_t *si, void *context)/*{{{*/
 
 	logd(LOG_DEBUG, "%s waiting service at condition variable\n", __func__);
 	pthread_cond_wait(&uvm->cond, &uvm->mutex);
+	if(uvm->result != 0) {
+		logd(LOG_DEBUG, "fault not serviced, out of swap. aborting.\n");
+		fprintf(stderr, "out of swap space.\n");
+		fprintf(stderr, "address %p not serviced.\n", (void *)va);
+		exit(EXIT_FAILURE);
+	}
 	pthread_mutex_unlock(&uvm->mutex);
 	logd(LOG_DEBUG, "%s returning\n", __func__);
 }/*}}}*/
@@ -269,6 +545,17 @@ void uvm_proto_extend_rep(void)/*{{{*/
 	pthread_cond_signal(&uvm->cond);
 }/*}}}*/
 
+void uvm_proto_extend_range_rep(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "processing EXTEND_RANGE_REP\n");
+	struct mmu_proto_extend_range_rep rep;
+	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		prexit();
+	assert(rep.type == MMU_PROTO_EXTEND_RANGE_REP);
+	uvm->result = (intptr_t)rep.vaddr;
+	pthread_cond_signal(&uvm->cond);
+}/*}}}*/
+
 void uvm_proto_syslog_rep(void)/*{{{*/
 {
 	logd(LOG_DEBUG, "processing SYSLOG_REP\n");
@@ -280,6 +567,81 @@ void uvm_proto_syslog_rep(void)/*{{{*/
 	pthread_cond_signal(&uvm->cond);
 }/*}}}*/
 
+void uvm_proto_release_rep(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "processing RELEASE_REP\n");
+	struct mmu_proto_release_rep rep;
+	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		prexit();
+	assert(rep.type == MMU_PROTO_RELEASE_REP);
+	uvm->result = (intptr_t)rep.retcode;
+	pthread_cond_signal(&uvm->cond);
+}/*}}}*/
+
+void uvm_proto_advise_rep(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "processing ADVISE_REP\n");
+	struct mmu_proto_advise_rep rep;
+	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		prexit();
+	assert(rep.type == MMU_PROTO_ADVISE_REP);
+	uvm->result = (intptr_t)rep.retcode;
+	pthread_cond_signal(&uvm->cond);
+}/*}}}*/
+
+void uvm_proto_lock_rep(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "processing LOCK_REP\n");
+	struct mmu_proto_lock_rep rep;
+	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		prexit();
+	assert(rep.type == MMU_PROTO_LOCK_REP);
+	uvm->result = (intptr_t)rep.retcode;
+	pthread_cond_signal(&uvm->cond);
+}/*}}}*/
+
+void uvm_proto_unlock_rep(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "processing UNLOCK_REP\n");
+	struct mmu_proto_unlock_rep rep;
+	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		prexit();
+	assert(rep.type == MMU_PROTO_UNLOCK_REP);
+	uvm->result = (intptr_t)rep.retcode;
+	pthread_cond_signal(&uvm->cond);
+}/*}}}*/
+
+void uvm_proto_setlimit_rep(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "processing SETLIMIT_REP\n");
+	struct mmu_proto_setlimit_rep rep;
+	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		prexit();
+	assert(rep.type == MMU_PROTO_SETLIMIT_REP);
+	uvm->result = (intptr_t)rep.retcode;
+	pthread_cond_signal(&uvm->cond);
+}/*}}}*/
+
+void uvm_proto_usage_rep(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "processing USAGE_REP\n");
+	struct mmu_proto_usage_rep rep;
+	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep))
+		prexit();
+	assert(rep.type == MMU_PROTO_USAGE_REP);
+	if(rep.retcode == 0 && uvm->usage != NULL) {
+		uvm->usage->resident = rep.resident;
+		uvm->usage->swapped = rep.swapped;
+		uvm->usage->dirty = rep.dirty;
+		uvm->usage->faults = rep.faults;
+		uvm->usage->pages = rep.pages;
+		for(int i = 0; i < UVM_LIMIT_COUNT; i++)
+			uvm->usage->limits[i] = rep.limits[i];
+	}
+	uvm->result = (intptr_t)rep.retcode;
+	pthread_cond_signal(&uvm->cond);
+}/*}}}*/
+
 void uvm_proto_segv_rep(void)/*{{{*/
 {
 	logd(LOG_DEBUG, "processing SEGV_REP\n");
@@ -287,6 +649,7 @@ void uvm_proto_segv_rep(void)/*{{{*/
 	if(recv(uvm->sock, &rep, sizeof(rep), 0) != sizeof(rep))
 		prexit();
 	assert(rep.type == MMU_PROTO_SEGV_REP);
+	uvm->result = (intptr_t)rep.retcode;
 	pthread_cond_signal(&uvm->cond);
 }/*}}}*/
 
@@ -345,6 +708,30 @@ void uvm_proto_chprot_rep(void)/*{{{*/
 	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req)) prexit();
 }/*}}}*/
 
+void uvm_proto_chprot_vec_rep(void)/*{{{*/
+{
+	logd(LOG_DEBUG, "processing CHPROT_VEC_REP\n");
+	struct mmu_proto_chprot_vec_rep rep;
+	if(recv(uvm->sock, &rep, sizeof(rep), MSG_WAITALL) != sizeof(rep))
+		prexit();
+	assert(rep.type == MMU_PROTO_CHPROT_VEC_REP);
+	assert(rep.count <= MMU_PROTO_CHPROT_VEC_MAX);
+
+	int prot = (int)rep.prot;
+	size_t pagesz = sysconf(_SC_PAGESIZE);
+	for(uint32_t i = 0; i < rep.count; ++i) {
+		assert(rep.vaddr[i] < UINTPTR_MAX);
+		void *addr = (void *)(uintptr_t)rep.vaddr[i];
+		logd(LOG_DEBUG, "mprotect %p prot %d\n", addr, prot);
+		if(mprotect(addr, pagesz, prot) == -1)
+			prexit();
+	}
+
+	struct mmu_proto_chprot_vec_req req;
+	req.type = MMU_PROTO_CHPROT_VEC_REQ;
+	if(send(uvm->sock, &req, sizeof(req), 0) != sizeof(req)) prexit();
+}/*}}}*/
+
 /****************************************************************************
  * external functions
  ***************************************************************************/
@@ -6,6 +6,7 @@
 #define __UVM_HEADER__
 
 #include <stdlib.h>
+#include <sys/types.h>
 
 /* `uvm_create` should be called when a program starts to bind it to
  * the memory management infrastructure.  This function sets up
@@ -22,6 +23,109 @@ void uvm_create(void);
  * system page size is given by `sysconf(_SC_PAGESIZE)`. */
 void * uvm_extend(void);
 
+/* `uvm_extend_n` allocates `n` contiguous pages for the calling
+ * process with a single request to the memory infrastructure and
+ * returns the address of the first one.  Either all pages are
+ * allocated or none is: on failure, returns NULL and sets `errno` to
+ * ENOSPC (or to EINVAL if `n` is zero). */
+void * uvm_extend_n(size_t n);
+
+/* `uvm_fork` creates a child process like `fork`, already bound to
+ * the memory management infrastructure (the child must not call
+ * `uvm_create`).  The child's pages are copy-on-write copies of the
+ * caller's: they share physical frames and disk blocks until either
+ * process writes to them.  No other thread may access memory
+ * allocated with `uvm_extend` during the call.  Returns the child's
+ * PID to the parent and 0 to the child; on failure, returns -1 and
+ * sets `errno` (to ENOMEM if the swap (disk) could not hold a
+ * private copy of every shared page). */
+pid_t uvm_fork(void);
+
+/* `uvm_release` gives back to the memory infrastructure the pages
+ * covering `len` bytes starting at `addr`, which must be page-aligned
+ * and managed by the memory infrastructure.  The pages stay
+ * allocated, but their content is dropped: the next access to each
+ * of them sees zero-filled memory, as with `madvise(MADV_DONTNEED)`.
+ * Returns 0 on success; on failure, returns -1 and sets `errno` to
+ * EINVAL. */
+int uvm_release(void *addr, size_t len);
+
+/* Access patterns for `uvm_advise`. */
+#define UVM_ADV_NORMAL 0
+#define UVM_ADV_SEQUENTIAL 1
+#define UVM_ADV_RANDOM 2
+#define UVM_ADV_WILLNEED 3
+#define UVM_ADV_DONTNEED 4
+#define UVM_ADV_COLD 5
+
+/* `uvm_advise` tells the memory infrastructure how the pages covering
+ * `len` bytes starting at `addr` will be accessed, as with `madvise`.
+ * `addr` must be page-aligned and every page must be managed by the
+ * memory infrastructure.  UVM_ADV_SEQUENTIAL makes faults read the
+ * following pages from disk ahead of time and lets pages already
+ * scanned be reused first; UVM_ADV_RANDOM disables reading ahead;
+ * UVM_ADV_NORMAL undoes both.  UVM_ADV_WILLNEED starts reading the
+ * pages that are on disk, UVM_ADV_DONTNEED is `uvm_release`, and
+ * UVM_ADV_COLD makes resident pages the first ones to be paged out.
+ * Advice is a hint and never changes the content of the pages
+ * (except for UVM_ADV_DONTNEED).  Returns 0 on success; on failure,
+ * returns -1 and sets `errno` to EINVAL. */
+int uvm_advise(void *addr, size_t len, int advice);
+
+/* `uvm_lock` pins the pages covering `len` bytes starting at `addr`
+ * in physical memory, as with `mlock`: they are faulted in with read
+ * access and are never paged out, so reading them causes no page
+ * faults; the first write to each page still faults once to gain
+ * write access.  `addr` must be page-aligned and every page must be
+ * managed by the memory infrastructure.  Each process may pin a
+ * limited number of pages.  Returns 0 on success; on failure, returns
+ * -1 and sets `errno` to EINVAL (invalid range) or ENOMEM (limit
+ * exceeded or swap out of space).  `uvm_unlock` makes the pages
+ * pageable again and returns 0, or -1 with `errno` set to EINVAL.  A
+ * page shared with a child after `uvm_fork` stays shared until its
+ * first write, which gives it a private copy that stays pinned. */
+int uvm_lock(void *addr, size_t len);
+int uvm_unlock(void *addr, size_t len);
+
+/* Per-process resources for `uvm_setlimit`: frames of physical
+ * memory, pages stored on disk and pages allocated with `uvm_extend`. */
+#define UVM_LIMIT_RESIDENT 0
+#define UVM_LIMIT_SWAP 1
+#define UVM_LIMIT_PAGES 2
+#define UVM_LIMIT_COUNT 3
+
+/* Usage counters of a process, filled by `uvm_getusage`.  `limits`
+ * is indexed by the `UVM_LIMIT_*` constants; 0 means unlimited. */
+struct uvm_usage {
+	unsigned long resident;
+	unsigned long swapped;
+	unsigned long dirty;
+	unsigned long faults;
+	unsigned long pages;
+	unsigned long limits[UVM_LIMIT_COUNT];
+};
+
+/* `uvm_setlimit` limits one resource (a `UVM_LIMIT_*` constant) of
+ * process `pid`, or of the calling process if `pid` is 0, as with
+ * `setrlimit`; `limit` 0 removes the limit.  Processes start with
+ * the limits given to the MMU and children created by `uvm_fork`
+ * inherit their parent's.  A process at its resident limit pages out
+ * its own pages to service its faults; one at its swap limit cannot
+ * have more pages written to disk, so its faults fail (and it is
+ * terminated) when all its resident pages would need to be; one at
+ * its page limit fails `uvm_extend` (with ENOSPC).  Returns 0 on
+ * success; on failure, returns -1 and sets `errno` to EINVAL (unknown
+ * resource) or ESRCH (unknown process). */
+int uvm_setlimit(pid_t pid, int resource, unsigned long limit);
+
+/* `uvm_getusage` fills `usage` with the counters of process `pid`, or
+ * of the calling process if `pid` is 0: frames in physical memory,
+ * pages stored on disk, resident pages modified since they were last
+ * written to disk, page faults serviced and pages allocated.
+ * Returns 0 on success; on failure, returns -1 and sets `errno` to
+ * ESRCH. */
+int uvm_getusage(pid_t pid, struct uvm_usage *usage);
+
 /* `uvm_syslog` requests the memory infrastructure to write the
  * string at `addr` with `len` bytes.  Memory at `addr` must be
  * managed by the memory infrastructure (i.e., allocated with